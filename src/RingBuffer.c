@@ -1,5 +1,7 @@
 #include "RingBuffer.h"
 
+#include "port/port_trace.h"
+
 #ifndef nullptr
 #ifdef NULL
 #define nullptr NULL
@@ -10,15 +12,34 @@
 
 uint32_t RingBufferLibraryBit(void)
 {
-#if _WIN64
+#if _WIN64 || defined(__LP64__)
     return 64;
-#elif _WIN32
+#elif _WIN32 || defined(__ILP32__)
     return 32;
 #else
     return 0;
 #endif
 }
 
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+
+static void _RingBufferPublish(RingBuffer *rb)
+{
+    if (rb->pendLen == 0) {
+        return;
+    }
+
+    /* The data is in place before the consumer can see it */
+    RB_MEMORY_BARRIER();
+    rb->tail = rb->pendTail;
+    rb->totalIn += rb->pendLen;
+    rb->pendLen = 0;
+    rb->dataHasPut = 1;
+    rb->consumerWaiting = 0;
+}
+
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+
 static int RingBufferModeSwitchTo(RingBuffer *rb, RingBufferMode mode)
 {
     if (rb == nullptr) {
@@ -39,6 +60,13 @@ static int RingBufferModeSwitchTo(RingBuffer *rb, RingBufferMode mode)
         }
         case RINGBUFFER_CPU_MODE:
         {
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+            /* Nothing to publish into once the ring is deinitialised */
+            if (mode != RINGBUFFER_INVALID_MODE) {
+                _RingBufferPublish(rb);
+            }
+            rb->publishEvery = 0;
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
             rb->mode = mode;
             break;
         }
@@ -47,6 +75,11 @@ static int RingBufferModeSwitchTo(RingBuffer *rb, RingBufferMode mode)
             rb->mode = mode;
             break;
         }
+        case RINGBUFFER_DMA_TX_MODE:
+        {
+            rb->mode = mode;
+            break;
+        }
         default:
             return RB_ERROR;
     }
@@ -54,27 +87,163 @@ static int RingBufferModeSwitchTo(RingBuffer *rb, RingBufferMode mode)
     return RB_OK;
 }
 
+#if RINGBUFFER_USE_STATISTICS
+
+static void _RingBufferStatReset(RingBuffer *rb)
+{
+    rb->prodStat.calls = 0;
+    rb->prodStat.fullTimes = 0;
+    rb->prodStat.shortTimes = 0;
+    rb->prodStat.truncatedBytes = 0;
+    rb->prodStat.highWaterMark = 0;
+    rb->prodStat.baseIn = rb->totalIn;
+
+    rb->consStat.calls = 0;
+    rb->consStat.emptyTimes = 0;
+    rb->consStat.baseOut = rb->totalOut;
+}
+
+static void _RingBufferStatHighWaterMarkUpdate(RingBuffer *rb, uint64_t len)
+{
+    if (len > rb->size) {
+        len = rb->size;
+    }
+    if (len > rb->prodStat.highWaterMark) {
+        rb->prodStat.highWaterMark = (uint32_t)len;
+    }
+}
+
+#endif  /* RINGBUFFER_USE_STATISTICS */
+
 #if RINGBUFFER_USE_DMA_MODE
 
+static int _RingBufferDMAConfigCall(RingBuffer *rb, RB_ADDRESS src, RB_ADDRESS det, uint32_t size)
+{
+    if (rb->dmaOps) {
+        return rb->dmaOps->DmaConfig ? rb->dmaOps->DmaConfig(rb->dmaCtx, src, det, size) : RB_OK;
+    }
+    return rb->DmaConfig ? rb->DmaConfig(src, det, size) : RB_OK;
+}
+
+static int _RingBufferDMAStartCall(RingBuffer *rb)
+{
+    if (rb->dmaOps) {
+        return rb->dmaOps->DmaStart ? rb->dmaOps->DmaStart(rb->dmaCtx) : RB_OK;
+    }
+    return rb->DmaStart ? rb->DmaStart() : RB_OK;
+}
+
+static int _RingBufferDMAStopCall(RingBuffer *rb)
+{
+    if (rb->dmaOps) {
+        return rb->dmaOps->DmaStop ? rb->dmaOps->DmaStop(rb->dmaCtx) : RB_OK;
+    }
+    return rb->DmaStop ? rb->DmaStop() : RB_OK;
+}
+
+static int _RingBufferDMAHasRecvedLen(RingBuffer *rb)
+{
+    return rb->dmaOps ? (rb->dmaOps->DmaRecvedLen != nullptr) : (rb->DmaRecvedLen != nullptr);
+}
+
+static uint32_t _RingBufferDMARecvedLenCall(RingBuffer *rb)
+{
+    if (rb->dmaOps) {
+        return rb->dmaOps->DmaRecvedLen(rb->dmaCtx);
+    }
+    return rb->DmaRecvedLen();
+}
+
+static int _RingBufferHasCleanCache(RingBuffer *rb)
+{
+    return rb->dmaOps ? (rb->dmaOps->CleanCache != nullptr) : (rb->CleanCache != nullptr);
+}
+
+static int _RingBufferHasInvalidCache(RingBuffer *rb)
+{
+    return rb->dmaOps ? (rb->dmaOps->InvalidCache != nullptr) : (rb->InvalidCache != nullptr);
+}
+
+static void _RingBufferDMACallbacksClear(RingBuffer *rb)
+{
+    rb->DmaConfig = nullptr;
+    rb->DmaStart = nullptr;
+    rb->DmaStop = nullptr;
+    rb->DmaRecvedLen = nullptr;
+
+    rb->CleanCache = nullptr;
+    rb->InvalidCache = nullptr;
+
+    rb->dmaOps = nullptr;
+    rb->dmaCtx = nullptr;
+}
+
 static void _RingBufferDMAModeUpdateLen(RingBuffer *rb)
 {
     uint32_t recvedLen = 0;
-
-    if (rb->DmaRecvedLen && rb->dmaState == RINGBUFFER_DMA_BUSY) {
-        recvedLen = rb->DmaRecvedLen();
+    RB_ADDRESS detAddr;
+    uint64_t pos;
+    uint32_t out;
+
+    if (_RingBufferDMAHasRecvedLen(rb) && rb->dmaState == RINGBUFFER_DMA_BUSY) {
+        out = rb->dmaQueueOut;
+        RB_MEMORY_BARRIER();
+        detAddr = rb->detAddr;
+        pos = rb->totalIn;
+        recvedLen = _RingBufferDMARecvedLenCall(rb);
         if (recvedLen > rb->blockSize) {
             return;
         }
+        /* The block completed meanwhile, recvedLen may belong to the old detAddr */
+        RB_MEMORY_BARRIER();
+        if (rb->dmaState != RINGBUFFER_DMA_BUSY || detAddr != rb->detAddr || out != rb->dmaQueueOut) {
+            return;
+        }
+
+#if RINGBUFFER_USE_DMA_CIRCULAR
+        if (!rb->dmaCircular)
+#endif  /* RINGBUFFER_USE_DMA_CIRCULAR */
+        {
+            /*
+             * An engine that chained into the queued block before Complete
+             * ran counts the new block already. Added to the old detAddr that
+             * would move tail backwards, keep it where it was instead.
+             */
+            pos += recvedLen;
+            if (pos < rb->dmaRecvedPos) {
+                return;
+            }
+            rb->dmaRecvedPos = pos;
+        }
+
+        rb->tail = (detAddr - (RB_ADDRESS)&rb->buff[0] + recvedLen) % rb->size;
+    }
+}
+
+/*
+ * Received and not yet read. In circular mode totalIn only moves at the
+ * HT/TC events while the reader follows the live tail, so what lies past
+ * the last accounted event is counted too and totalOut never overtakes.
+ */
+static uint64_t _RingBufferDMAModeUnread(RingBuffer *rb)
+{
+    uint64_t in = rb->totalIn;
 
-        rb->tail = (rb->detAddr - (RB_ADDRESS)&rb->buff[0] + recvedLen) % rb->size;
+#if RINGBUFFER_USE_DMA_CIRCULAR
+    if (rb->dmaCircular) {
+        in += (rb->tail + rb->size - rb->dmaEventPos) % rb->size;
     }
+#endif  /* RINGBUFFER_USE_DMA_CIRCULAR */
+
+    return in - rb->totalOut;
 }
 
 #if RINGBUFFER_USE_RX_OVERFLOW
 
 static int _RingBufferDMAModeCheckOverflow(RingBuffer *rb)
 {
-    if (rb->totalIn - rb->totalOut > rb->size) {
+    /* A full lap unread leaves tail on head, the reader would see it empty */
+    if (_RingBufferDMAModeUnread(rb) >= rb->size) {
         return 1;
     } else {
         return 0;
@@ -83,6 +252,295 @@ static int _RingBufferDMAModeCheckOverflow(RingBuffer *rb)
 
 #endif  /* RINGBUFFER_USE_RX_OVERFLOW */
 
+static void _RingBufferDMAModeAccount(RingBuffer *rb, uint32_t len)
+{
+    rb->dataHasPut = 1;
+
+    rb->totalIn += len;
+#if RINGBUFFER_USE_RX_OVERFLOW
+    if (_RingBufferDMAModeCheckOverflow(rb)) {
+        rb->overflowTimes++;
+    }
+#endif  /* RINGBUFFER_USE_RX_OVERFLOW */
+#if RINGBUFFER_USE_STATISTICS
+    rb->prodStat.calls++;
+    _RingBufferStatHighWaterMarkUpdate(rb, _RingBufferDMAModeUnread(rb));
+#endif  /* RINGBUFFER_USE_STATISTICS */
+}
+
+#if RINGBUFFER_USE_DMA_CIRCULAR
+
+/*
+ * The engine lapped the reader: move head onto `head`, the oldest byte
+ * still worth reading, so the ring does not look empty. dmaEventPos is
+ * the ring offset accounted into totalIn so far, tail may already be ahead.
+ */
+static void _RingBufferDMACircularOverrun(RingBuffer *rb, uint32_t head)
+{
+    uint32_t ahead;
+
+    if (_RingBufferDMAModeUnread(rb) < rb->size) {
+        return;
+    }
+
+    ahead = (rb->tail + rb->size - rb->dmaEventPos) % rb->size;
+    rb->head = head;
+    rb->totalOut = rb->totalIn + ahead - (rb->tail + rb->size - head) % rb->size;
+}
+
+#endif  /* RINGBUFFER_USE_DMA_CIRCULAR */
+
+#if RINGBUFFER_DMA_STRIPE_CHANNELS
+
+/*
+ * A finished stripe tail can move over: the next one in line, unless it
+ * wrapped past the unused end of the ring. Only the reader jumps that gap,
+ * from RingBufferGet() once it has drained everything in front of it.
+ */
+static int _RingBufferDMAStripeReady(RingBuffer *rb, uint32_t out, int reader)
+{
+    RingBufferDMAStripe *stripe = &rb->dmaStripe[out % RINGBUFFER_DMA_STRIPE_DEPTH];
+
+    if (out == rb->dmaStripeIn || !stripe->done) {
+        return 0;
+    }
+    if (stripe->offset != rb->tail) {
+        return reader && rb->head == rb->tail;
+    }
+
+    return 1;
+}
+
+/* Move tail over the finished prefix; whoever holds dmaStripeLock does it for all */
+static void _RingBufferDMAStripeAdvance(RingBuffer *rb, int reader)
+{
+    RingBufferDMAStripe *stripe;
+    uint32_t out;
+
+    do {
+        if (!RB_ATOMIC_CAS(&rb->dmaStripeLock, 0, 1)) {
+            return;
+        }
+
+        out = rb->dmaStripeOut;
+        while (_RingBufferDMAStripeReady(rb, out, reader)) {
+            stripe = &rb->dmaStripe[out % RINGBUFFER_DMA_STRIPE_DEPTH];
+            if (stripe->offset != rb->tail) {
+                /* The ring is empty, nobody else reads head and tail here */
+                rb->head = stripe->offset;
+            }
+            rb->tail = (stripe->offset + stripe->size) % rb->size;
+            _RingBufferDMAModeAccount(rb, stripe->size);
+            RB_TRACE4(dma_complete, rb, stripe->size, rb->tail, rb->totalIn - rb->totalOut);
+            stripe->done = 0;
+            rb->dmaStripeOut = ++out;
+        }
+
+        rb->dmaStripeLock = 0;
+        RB_MEMORY_BARRIER();
+
+        /* A stripe may have finished after we looked and before we unlocked */
+        out = rb->dmaStripeOut;
+    } while (_RingBufferDMAStripeReady(rb, out, reader));
+}
+
+#endif  /* RINGBUFFER_DMA_STRIPE_CHANNELS */
+
+static void _RingBufferDMAModeQueueReset(RingBuffer *rb)
+{
+    rb->dmaQueueIn = 0;
+    rb->dmaQueueOut = 0;
+    rb->dmaQueueDone = 0;
+    rb->dmaRecvedPos = 0;
+    rb->dmaStartLock = 0;
+
+#if RINGBUFFER_USE_DMA_CIRCULAR
+    rb->dmaCircular = 0;
+    rb->dmaEventPos = 0;
+#endif  /* RINGBUFFER_USE_DMA_CIRCULAR */
+
+#if RINGBUFFER_DMA_STRIPE_CHANNELS
+    rb->dmaChannelNum = 0;
+    RB_MEMSET((void *)rb->dmaChannelSlot, 0, sizeof(rb->dmaChannelSlot));
+    rb->dmaStripeIn = 0;
+    rb->dmaStripeOut = 0;
+    rb->dmaStripeLock = 0;
+    rb->dmaStripeTail = 0;
+#endif  /* RINGBUFFER_DMA_STRIPE_CHANNELS */
+}
+
+static void _RingBufferDMAModeQueuePush(RingBuffer *rb, RB_ADDRESS src, RB_ADDRESS det, uint32_t size)
+{
+    RingBufferDMADesc *desc = &rb->dmaQueue[rb->dmaQueueIn % RINGBUFFER_DMA_QUEUE_DEPTH];
+
+    desc->src = src;
+    desc->det = det;
+    desc->size = size;
+
+    RB_MEMORY_BARRIER();
+    rb->dmaQueueIn++;
+}
+
+static void _RingBufferDMAModeLoadDesc(RingBuffer *rb, const RingBufferDMADesc *desc)
+{
+    rb->srcAddr = desc->src;
+    rb->blockSize = desc->size;
+    rb->detAddr = desc->det;
+}
+
+static void _RingBufferCacheOp(RingBuffer *rb, int clean, uint32_t offset, uint32_t len)
+{
+    RB_ADDRESS start = (RB_ADDRESS)&rb->buff[offset];
+    RB_ADDRESS end = start + len;
+
+    start &= ~(RB_ADDRESS)(RINGBUFFER_CACHE_LINE_SIZE - 1);
+    end = (end + RINGBUFFER_CACHE_LINE_SIZE - 1) & ~(RB_ADDRESS)(RINGBUFFER_CACHE_LINE_SIZE - 1);
+
+    if (rb->dmaOps) {
+        if (clean) {
+            rb->dmaOps->CleanCache(rb->dmaCtx, start, (uint32_t)(end - start));
+        } else {
+            rb->dmaOps->InvalidCache(rb->dmaCtx, start, (uint32_t)(end - start));
+        }
+    } else {
+        if (clean) {
+            rb->CleanCache(start, (uint32_t)(end - start));
+        } else {
+            rb->InvalidCache(start, (uint32_t)(end - start));
+        }
+    }
+}
+
+static void _RingBufferCacheCleanFlush(RingBuffer *rb)
+{
+    if (rb->cleanLen) {
+        _RingBufferCacheOp(rb, 1, rb->cleanStart, rb->cleanLen);
+        rb->cleanLen = 0;
+    }
+}
+
+/* Clean [offset, offset + len) of the ring, merged into the pending range in a batch */
+static void _RingBufferCacheClean(RingBuffer *rb, uint32_t offset, uint32_t len)
+{
+    uint32_t seg;
+
+    if (!_RingBufferHasCleanCache(rb)) {
+        return;
+    }
+
+    while (len) {
+        seg = (offset + len <= rb->size) ? len : (rb->size - offset);
+
+        if (rb->cacheBatch && rb->cleanLen && rb->cleanStart + rb->cleanLen == offset) {
+            rb->cleanLen += seg;
+        } else {
+            _RingBufferCacheCleanFlush(rb);
+            rb->cleanStart = offset;
+            rb->cleanLen = seg;
+        }
+        if (!rb->cacheBatch) {
+            _RingBufferCacheCleanFlush(rb);
+        }
+
+        offset = (offset + seg) % rb->size;
+        len -= seg;
+    }
+}
+
+/*
+ * Before reading `size` of the `len` readable bytes at head: invalidate
+ * the whole readable region unless an earlier call already did. The line
+ * holding the write position is left out of invalidUpTo, the dma may
+ * still be filling it.
+ */
+static void _RingBufferCacheInvalidate(RingBuffer *rb, uint32_t size, uint32_t len)
+{
+    uint64_t from = rb->totalOut;
+    uint64_t end = rb->totalOut + len;
+    uint32_t offset;
+    uint32_t n;
+    uint32_t seg;
+    uint32_t partial;
+
+    if (!_RingBufferHasInvalidCache(rb)) {
+        return;
+    }
+    if (from + size <= rb->invalidUpTo) {
+        return;
+    }
+    if (from < rb->invalidUpTo) {
+        from = rb->invalidUpTo;
+    }
+
+    offset = (uint32_t)((rb->head + (from - rb->totalOut)) % rb->size);
+    n = (uint32_t)(end - from);
+    while (n) {
+        seg = (offset + n <= rb->size) ? n : (rb->size - offset);
+        _RingBufferCacheOp(rb, 0, offset, seg);
+        offset = (offset + seg) % rb->size;
+        n -= seg;
+    }
+
+    partial = (uint32_t)((RB_ADDRESS)&rb->buff[offset] & (RINGBUFFER_CACHE_LINE_SIZE - 1));
+    if (partial > len) {
+        partial = len;
+    }
+    rb->invalidUpTo = end - partial;
+}
+
+/* Caller owns the engine (dmaState BUSY); launches the next block from head */
+static int _RingBufferDMATxKick(RingBuffer *rb)
+{
+    uint32_t head = rb->head;
+    uint32_t tail = rb->tail;
+    uint32_t size;
+    int status;
+
+    size = (tail >= head) ? (tail - head) : (rb->size - head);
+#if RINGBUFFER_DMA_TX_MAX_BLOCK
+    if (size > RINGBUFFER_DMA_TX_MAX_BLOCK) {
+        size = RINGBUFFER_DMA_TX_MAX_BLOCK;
+    }
+#endif  /* RINGBUFFER_DMA_TX_MAX_BLOCK */
+    if (size == 0) {
+        return RB_ERROR_INVALID;
+    }
+
+    rb->srcAddr = (RB_ADDRESS)&rb->buff[head];
+    rb->blockSize = size;
+
+    status = _RingBufferDMAConfigCall(rb, rb->srcAddr, rb->detAddr, rb->blockSize);
+    if (status) {
+        return status;
+    }
+
+    RB_TRACE4(dma_config, rb, rb->srcAddr, rb->detAddr, rb->blockSize);
+
+    status = _RingBufferDMAStartCall(rb);
+    if (status) {
+        return status;
+    }
+
+    RB_TRACE4(dma_start, rb, rb->srcAddr, rb->blockSize, head);
+
+    return RB_OK;
+}
+
+/* Claim an idle engine if there is data to send, from Put or Complete */
+static void _RingBufferDMATxTryKick(RingBuffer *rb)
+{
+    /* Data put inside a cache batch is not cleaned yet */
+    if (rb->dmaState != RINGBUFFER_DMA_READY || rb->tail == rb->head || rb->cacheBatch) {
+        return;
+    }
+    if (!RB_ATOMIC_CAS(&rb->dmaState, RINGBUFFER_DMA_READY, RINGBUFFER_DMA_BUSY)) {
+        return;
+    }
+    if (_RingBufferDMATxKick(rb)) {
+        rb->dmaState = RINGBUFFER_DMA_READY;
+    }
+}
+
 #endif  /* RINGBUFFER_USE_DMA_MODE */
 
 int RingBufferCreate(RingBuffer *rb, uint32_t size)
@@ -142,6 +600,28 @@ int RingBufferInit(RingBuffer *rb, uint8_t *buff, uint32_t size)
     rb->totalIn = 0;
     rb->totalOut = 0;
 
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+    rb->publishEvery = 0;
+    rb->pendTail = 0;
+    rb->pendLen = 0;
+    rb->consumerWaiting = 0;
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+
+#if RINGBUFFER_USE_STATISTICS
+    _RingBufferStatReset(rb);
+#endif  /* RINGBUFFER_USE_STATISTICS */
+
+#if RINGBUFFER_USE_DMA_MODE
+    rb->dmaState = RINGBUFFER_DMA_ERROR;
+    _RingBufferDMAModeQueueReset(rb);
+
+    _RingBufferDMACallbacksClear(rb);
+
+    rb->cacheBatch = 0;
+    rb->cleanLen = 0;
+    rb->invalidUpTo = 0;
+#endif  /* RINGBUFFER_USE_DMA_MODE */
+
     return RingBufferModeSwitchTo(rb, RINGBUFFER_CPU_MODE);
 }
 
@@ -165,6 +645,13 @@ int RingBufferDeinit(RingBuffer *rb)
     rb->totalIn = 0;
     rb->totalOut = 0;
 
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+    rb->publishEvery = 0;
+    rb->pendTail = 0;
+    rb->pendLen = 0;
+    rb->consumerWaiting = 0;
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+
     return RingBufferModeSwitchTo(rb, RINGBUFFER_INVALID_MODE);
 }
 
@@ -192,6 +679,22 @@ uint32_t RingBufferSizeGet(RingBuffer *rb)
     return rb->size;
 }
 
+uint32_t RingBufferSpaceGet(RingBuffer *rb)
+{
+    uint32_t len;
+
+    if (rb == nullptr || rb->size <= 0) {
+        return 0;
+    }
+
+    len = RingBufferLenGet(rb);
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+    len += rb->pendLen;
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+
+    return len < rb->size ? rb->size - 1 - len : 0;
+}
+
 uint64_t RingBufferTotalInGet(RingBuffer *rb)
 {
     if (rb == nullptr) {
@@ -219,65 +722,57 @@ uint64_t RingBufferOverflowTimesGet(RingBuffer *rb)
     return rb->overflowTimes;
 }
 
-uint32_t RingBufferPut(RingBuffer *rb, uint8_t *data, uint32_t size)
-{
-    uint32_t len;
+#if RINGBUFFER_USE_STATISTICS
 
-    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
-        return 0;
-    }
-    if (rb->mode != RINGBUFFER_CPU_MODE) {
-        return 0;
-    }
-    if (data == nullptr || size <= 0) {
-        return 0;
+int RingBufferStatisticsGet(RingBuffer *rb, RingBufferStatistics *stat)
+{
+    if (rb == nullptr || stat == nullptr) {
+        return RB_ERROR_PARAM;
     }
 
-    len = RingBufferLenGet(rb);
+    stat->size = rb->size;
+    stat->len = RingBufferLenGet(rb);
+    stat->highWaterMark = rb->prodStat.highWaterMark;
 
-    if (len >= rb->size) {
-        return 0;
-    }
+    stat->totalIn = rb->totalIn;
+    stat->totalOut = rb->totalOut;
+#if RINGBUFFER_USE_RX_OVERFLOW
+    stat->overflowTimes = rb->overflowTimes;
+#else
+    stat->overflowTimes = 0;
+#endif  /* RINGBUFFER_USE_RX_OVERFLOW */
 
-    if (size > rb->size - len - 1) {
-        size = rb->size - len - 1;
-    }
-    if (size == 0) {
-        return 0;
-    }
+    stat->putCalls = rb->prodStat.calls;
+    stat->getCalls = rb->consStat.calls;
+    stat->fullTimes = rb->prodStat.fullTimes;
+    stat->emptyTimes = rb->consStat.emptyTimes;
+    stat->shortTimes = rb->prodStat.shortTimes;
+    stat->truncatedBytes = rb->prodStat.truncatedBytes;
 
-    if (rb->tail + size <= rb->size) {
-        RB_MEMCPY(&rb->buff[rb->tail], &data[0], size);
-        if (rb->CleanCache) {
-            rb->CleanCache((RB_ADDRESS)&rb->buff[rb->tail], size);
-        }
-    } else {
-        RB_MEMCPY(&rb->buff[rb->tail], &data[0], rb->size - rb->tail);
-        RB_MEMCPY(&rb->buff[0], &data[rb->size - rb->tail], size - (rb->size - rb->tail));
-        if (rb->CleanCache) {
-            rb->CleanCache((RB_ADDRESS)&rb->buff[rb->tail], rb->size - rb->tail);
-            rb->CleanCache((RB_ADDRESS)&rb->buff[0], size - (rb->size - rb->tail));
-        }
+    /* The call counters restart at a reset, the byte totals do not */
+    stat->avgPutSize = stat->putCalls ? (uint32_t)((stat->totalIn - rb->prodStat.baseIn) / stat->putCalls) : 0;
+    stat->avgGetSize = stat->getCalls ? (uint32_t)((stat->totalOut - rb->consStat.baseOut) / stat->getCalls) : 0;
+
+    return RB_OK;
+}
+
+int RingBufferStatisticsReset(RingBuffer *rb)
+{
+    if (rb == nullptr) {
+        return RB_ERROR_PARAM;
     }
-    rb->tail = (rb->tail + size) % rb->size;
-    rb->totalIn += size;
 
-    rb->dataHasPut = 1;
+    _RingBufferStatReset(rb);
 
-    return size;
+    return RB_OK;
 }
 
-uint32_t RingBufferGet(RingBuffer *rb, uint8_t *data, uint32_t size)
+#endif  /* RINGBUFFER_USE_STATISTICS */
+
+static uint32_t _RingBufferReadableLen(RingBuffer *rb)
 {
     uint32_t len;
 
-    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
-        return 0;
-    }
-    if (data == nullptr || size <= 0) {
-        return 0;
-    }
-
 #if RINGBUFFER_USE_LATEST_LEN
     do {
         if (rb->dataHasPut) {
@@ -292,96 +787,740 @@ uint32_t RingBufferGet(RingBuffer *rb, uint8_t *data, uint32_t size)
     } while (1);
 #endif  /* RINGBUFFER_USE_LATEST_LEN */
 
-    if (len <= 0) {
-        return 0;
-    }
+    return len;
+}
+
+uint32_t RingBufferPut(RingBuffer *rb, uint8_t *data, uint32_t size)
+{
+    uint32_t len;
+    uint32_t tail;
+    uint32_t req = size;
+
+    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
+        return 0;
+    }
+    if (rb->mode != RINGBUFFER_CPU_MODE && rb->mode != RINGBUFFER_DMA_TX_MODE) {
+        return 0;
+    }
+    if (data == nullptr || size <= 0) {
+        return 0;
+    }
+
+#if RINGBUFFER_USE_STATISTICS
+    rb->prodStat.calls++;
+#endif  /* RINGBUFFER_USE_STATISTICS */
+
+    len = RingBufferLenGet(rb);
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+    len += rb->pendLen;
+    tail = rb->pendLen ? rb->pendTail : rb->tail;
+#else
+    tail = rb->tail;
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+
+    if (len >= rb->size) {
+#if RINGBUFFER_USE_STATISTICS
+        rb->prodStat.fullTimes++;
+        rb->prodStat.truncatedBytes += size;
+#endif  /* RINGBUFFER_USE_STATISTICS */
+        RB_TRACE5(put, rb, req, 0, rb->tail, len);
+        return 0;
+    }
+
+    if (size > rb->size - len - 1) {
+#if RINGBUFFER_USE_STATISTICS
+        if (rb->size - len - 1 == 0) {
+            rb->prodStat.fullTimes++;
+        } else {
+            rb->prodStat.shortTimes++;
+        }
+        rb->prodStat.truncatedBytes += size - (rb->size - len - 1);
+#endif  /* RINGBUFFER_USE_STATISTICS */
+        size = rb->size - len - 1;
+    }
+    if (size == 0) {
+        RB_TRACE5(put, rb, req, 0, rb->tail, len);
+        return 0;
+    }
+
+    if (tail + size <= rb->size) {
+        RB_MEMCPY(&rb->buff[tail], &data[0], size);
+    } else {
+        RB_MEMCPY(&rb->buff[tail], &data[0], rb->size - tail);
+        RB_MEMCPY(&rb->buff[0], &data[rb->size - tail], size - (rb->size - tail));
+    }
+#if RINGBUFFER_USE_DMA_MODE
+    _RingBufferCacheClean(rb, tail, size);
+#endif  /* RINGBUFFER_USE_DMA_MODE */
+
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+    if (rb->publishEvery) {
+        rb->pendTail = (tail + size) % rb->size;
+        rb->pendLen += size;
+        if (rb->pendLen >= rb->publishEvery || rb->consumerWaiting) {
+            _RingBufferPublish(rb);
+        }
+    } else
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+    {
+        rb->tail = (tail + size) % rb->size;
+        rb->totalIn += size;
+
+        rb->dataHasPut = 1;
+    }
+
+#if RINGBUFFER_USE_STATISTICS
+    _RingBufferStatHighWaterMarkUpdate(rb, len + size);
+#endif  /* RINGBUFFER_USE_STATISTICS */
+
+    RB_TRACE5(put, rb, req, size, rb->tail, len + size);
+
+#if RINGBUFFER_USE_DMA_MODE
+    if (rb->mode == RINGBUFFER_DMA_TX_MODE) {
+        /* Pairs with the re-check in RingBufferDMAComplete */
+        RB_MEMORY_BARRIER();
+        _RingBufferDMATxTryKick(rb);
+    }
+#endif  /* RINGBUFFER_USE_DMA_MODE */
+
+    return size;
+}
+
+uint32_t RingBufferGet(RingBuffer *rb, uint8_t *data, uint32_t size)
+{
+    uint32_t len;
+    uint32_t req = size;
+
+    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
+        return 0;
+    }
+    if (data == nullptr || size <= 0) {
+        return 0;
+    }
+    if (rb->mode == RINGBUFFER_DMA_TX_MODE) {
+        return 0;
+    }
+
+#if RINGBUFFER_USE_STATISTICS
+    rb->consStat.calls++;
+#endif  /* RINGBUFFER_USE_STATISTICS */
+
+#if RINGBUFFER_USE_DMA_MODE && RINGBUFFER_DMA_STRIPE_CHANNELS
+    /* A stripe that wrapped waits for the reader to jump the unused end */
+    if (rb->dmaChannelNum && rb->dmaStripeOut != rb->dmaStripeIn) {
+        _RingBufferDMAStripeAdvance(rb, 1);
+    }
+#endif  /* RINGBUFFER_USE_DMA_MODE && RINGBUFFER_DMA_STRIPE_CHANNELS */
+
+    len = _RingBufferReadableLen(rb);
+
+    if (len <= 0) {
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+        /* The next put publishes at once, write only on the first miss */
+        if (rb->publishEvery && !rb->consumerWaiting) {
+            rb->consumerWaiting = 1;
+        }
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+#if RINGBUFFER_USE_STATISTICS
+        rb->consStat.emptyTimes++;
+#endif  /* RINGBUFFER_USE_STATISTICS */
+        RB_TRACE5(get, rb, req, 0, rb->head, len);
+        return 0;
+    }
 
     if (size > len) {
         size = len;
     }
 
+#if RINGBUFFER_USE_DMA_MODE
+    _RingBufferCacheInvalidate(rb, size, len);
+#endif  /* RINGBUFFER_USE_DMA_MODE */
+
     if (rb->head + size <= rb->size) {
-        if (rb->InvalidCache) {
-            rb->InvalidCache((RB_ADDRESS)&rb->buff[rb->head], size);
-        }
         RB_MEMCPY(&data[0], &rb->buff[rb->head], size);
     } else {
-        if (rb->InvalidCache) {
-            rb->InvalidCache((RB_ADDRESS)&rb->buff[rb->head], rb->size - rb->head);
-            rb->InvalidCache((RB_ADDRESS)&rb->buff[0], size - (rb->size - rb->head));
-        }
         RB_MEMCPY(&data[0], &rb->buff[rb->head], rb->size - rb->head);
         RB_MEMCPY(&data[rb->size - rb->head], &rb->buff[0], size - (rb->size - rb->head));
     }
     rb->head = (rb->head + size) % rb->size;
     rb->totalOut += size;
 
-    return size;
+    RB_TRACE5(get, rb, req, size, rb->head, len - size);
+
+    return size;
+}
+
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+
+int RingBufferPublishBatchSet(RingBuffer *rb, uint32_t bytes)
+{
+    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->mode != RINGBUFFER_CPU_MODE) {
+        return RB_ERROR_INVALID;
+    }
+
+    if (bytes == 0) {
+        _RingBufferPublish(rb);
+    }
+    rb->publishEvery = bytes;
+
+    return RB_OK;
+}
+
+int RingBufferFlush(RingBuffer *rb)
+{
+    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
+        return RB_ERROR_PARAM;
+    }
+
+    _RingBufferPublish(rb);
+
+    return RB_OK;
+}
+
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+
+uint32_t RingBufferTransfer(RingBuffer *det, RingBuffer *src, uint32_t size, RINGBUFFER_TRANSFER_CB cb, void *arg)
+{
+    uint32_t srcLen;
+    uint32_t detLen;
+    uint32_t space;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t start;
+    uint32_t done;
+    uint32_t seg;
+    uint32_t req = size;
+
+    if (det == nullptr || det->buff == nullptr || det->size <= 0) {
+        return 0;
+    }
+    if (src == nullptr || src->buff == nullptr || src->size <= 0 || src == det) {
+        return 0;
+    }
+    if (det->mode != RINGBUFFER_CPU_MODE && det->mode != RINGBUFFER_DMA_TX_MODE) {
+        return 0;
+    }
+    if (src->mode == RINGBUFFER_DMA_TX_MODE || size <= 0) {
+        return 0;
+    }
+
+#if RINGBUFFER_USE_STATISTICS
+    src->consStat.calls++;
+    det->prodStat.calls++;
+#endif  /* RINGBUFFER_USE_STATISTICS */
+
+    srcLen = _RingBufferReadableLen(src);
+    detLen = RingBufferLenGet(det);
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+    detLen += det->pendLen;
+    start = det->pendLen ? det->pendTail : det->tail;
+#else
+    start = det->tail;
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+    space = detLen < det->size ? det->size - detLen - 1 : 0;
+
+    if (size > srcLen) {
+        size = srcLen;
+    }
+    if (size > space) {
+#if RINGBUFFER_USE_STATISTICS
+        if (space == 0) {
+            det->prodStat.fullTimes++;
+        } else {
+            det->prodStat.shortTimes++;
+        }
+        det->prodStat.truncatedBytes += size - space;
+#endif  /* RINGBUFFER_USE_STATISTICS */
+        size = space;
+    }
+    if (size == 0) {
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+        /* Same as a get that found src empty */
+        if (srcLen == 0 && src->publishEvery && !src->consumerWaiting) {
+            src->consumerWaiting = 1;
+        }
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+#if RINGBUFFER_USE_STATISTICS
+        if (srcLen == 0) {
+            src->consStat.emptyTimes++;
+        }
+#endif  /* RINGBUFFER_USE_STATISTICS */
+        RB_TRACE5(get, src, req, 0, src->head, srcLen);
+        RB_TRACE5(put, det, req, 0, det->tail, detLen);
+        return 0;
+    }
+
+#if RINGBUFFER_USE_DMA_MODE
+    _RingBufferCacheInvalidate(src, size, srcLen);
+#endif  /* RINGBUFFER_USE_DMA_MODE */
+
+    /* At most three segments, split wherever either ring wraps */
+    head = src->head;
+    tail = start;
+    for (done = 0; done < size; done += seg) {
+        seg = size - done;
+        if (seg > src->size - head) {
+            seg = src->size - head;
+        }
+        if (seg > det->size - tail) {
+            seg = det->size - tail;
+        }
+
+        RB_MEMCPY(&det->buff[tail], &src->buff[head], seg);
+        if (cb) {
+            cb(arg, &det->buff[tail], seg);
+        }
+
+        head = (head + seg) % src->size;
+        tail = (tail + seg) % det->size;
+    }
+
+#if RINGBUFFER_USE_DMA_MODE
+    _RingBufferCacheClean(det, start, size);
+#endif  /* RINGBUFFER_USE_DMA_MODE */
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+    if (det->publishEvery) {
+        det->pendTail = tail;
+        det->pendLen += size;
+        if (det->pendLen >= det->publishEvery || det->consumerWaiting) {
+            _RingBufferPublish(det);
+        }
+    } else
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+    {
+        det->tail = tail;
+        det->totalIn += size;
+        det->dataHasPut = 1;
+    }
+
+    src->head = head;
+    src->totalOut += size;
+
+#if RINGBUFFER_USE_STATISTICS
+    _RingBufferStatHighWaterMarkUpdate(det, detLen + size);
+#endif  /* RINGBUFFER_USE_STATISTICS */
+
+    RB_TRACE5(get, src, req, size, src->head, srcLen - size);
+    RB_TRACE5(put, det, req, size, det->tail, detLen + size);
+
+#if RINGBUFFER_USE_DMA_MODE
+    if (det->mode == RINGBUFFER_DMA_TX_MODE) {
+        RB_MEMORY_BARRIER();
+        _RingBufferDMATxTryKick(det);
+    }
+#endif  /* RINGBUFFER_USE_DMA_MODE */
+
+    return size;
+}
+
+#if RINGBUFFER_USE_DMA_MODE
+
+static void _RingBufferDMADeviceAttach(RingBuffer *rb)
+{
+    rb->dmaState = RINGBUFFER_DMA_IDLE;
+    rb->srcAddr = 0;
+    rb->detAddr = (RB_ADDRESS)&rb->buff[0];
+    rb->blockSize = 0;
+    _RingBufferDMAModeQueueReset(rb);
+
+    rb->cacheBatch = 0;
+    rb->cleanLen = 0;
+    rb->invalidUpTo = rb->totalOut;
+
+    RingBufferModeSwitchTo(rb, RINGBUFFER_DMA_MODE);
+}
+
+int RingBufferDMADeviceRegister(
+    RingBuffer *rb,
+    RINGBUFFER_DMA_CONFIG DmaConfig,
+    RINGBUFFER_DMA_START DmaStart,
+    RINGBUFFER_DMA_STOP DmaStop,
+    RINGBUFFER_DMA_RECVED_LEN DmaRecvedLen,
+    RINGBUFFER_CLEAN_CHCHE CleanCache,
+    RINGBUFFER_INVALID_CHCHE InvalidCache
+)
+{
+    if (rb == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+    if (DmaConfig == nullptr || DmaRecvedLen == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    _RingBufferDMACallbacksClear(rb);
+    rb->DmaConfig = DmaConfig;
+    rb->DmaStart = DmaStart;
+    rb->DmaStop = DmaStop;
+    rb->DmaRecvedLen = DmaRecvedLen;
+    rb->CleanCache = CleanCache;
+    rb->InvalidCache = InvalidCache;
+
+    _RingBufferDMADeviceAttach(rb);
+
+    return RB_OK;
+}
+
+int RingBufferDMADeviceRegisterEx(RingBuffer *rb, const RingBufferDMAOps *ops, void *ctx)
+{
+    if (rb == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+    if (ops == nullptr || ops->DmaConfig == nullptr || ops->DmaRecvedLen == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    _RingBufferDMACallbacksClear(rb);
+    rb->dmaOps = ops;
+    rb->dmaCtx = ctx ? ctx : (void *)rb;
+
+    _RingBufferDMADeviceAttach(rb);
+
+    return RB_OK;
+}
+
+int RingBufferDMADeviceUnregister(RingBuffer *rb)
+{
+    if (rb == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    RingBufferDMAStop(rb);
+
+    rb->dmaState = RINGBUFFER_DMA_ERROR;
+    rb->srcAddr = 0;
+    rb->detAddr = 0;
+    rb->blockSize = 0;
+    _RingBufferDMAModeQueueReset(rb);
+
+    _RingBufferDMACallbacksClear(rb);
+
+    rb->cacheBatch = 0;
+    rb->cleanLen = 0;
+
+    RingBufferModeSwitchTo(rb, RINGBUFFER_CPU_MODE);
+
+    return RB_OK;
+}
+
+int RingBufferDMATxDeviceRegister(
+    RingBuffer *rb,
+    RINGBUFFER_DMA_CONFIG DmaConfig,
+    RINGBUFFER_DMA_START DmaStart,
+    RINGBUFFER_DMA_STOP DmaStop,
+    RINGBUFFER_DMA_RECVED_LEN DmaRecvedLen,
+    RINGBUFFER_CLEAN_CHCHE CleanCache,
+    RINGBUFFER_INVALID_CHCHE InvalidCache
+)
+{
+    int status;
+
+    status = RingBufferDMADeviceRegister(rb, DmaConfig, DmaStart, DmaStop, DmaRecvedLen, CleanCache, InvalidCache);
+    if (status) {
+        return status;
+    }
+
+    rb->detAddr = 0;
+
+    return RingBufferModeSwitchTo(rb, RINGBUFFER_DMA_TX_MODE);
+}
+
+int RingBufferDMATxDeviceRegisterEx(RingBuffer *rb, const RingBufferDMAOps *ops, void *ctx)
+{
+    int status;
+
+    status = RingBufferDMADeviceRegisterEx(rb, ops, ctx);
+    if (status) {
+        return status;
+    }
+
+    rb->detAddr = 0;
+
+    return RingBufferModeSwitchTo(rb, RINGBUFFER_DMA_TX_MODE);
+}
+
+int RingBufferDMATxStart(RingBuffer *rb, RB_ADDRESS det)
+{
+    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
+        return RB_ERROR_PARAM;
+    }
+    if (det == 0) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->mode != RINGBUFFER_DMA_TX_MODE) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->dmaState != RINGBUFFER_DMA_IDLE) {
+        return RB_ERROR_INVALID;
+    }
+
+    rb->detAddr = det;
+    rb->dmaState = RINGBUFFER_DMA_READY;
+
+    RB_MEMORY_BARRIER();
+    _RingBufferDMATxTryKick(rb);
+
+    return RB_OK;
+}
+
+static int _RingBufferDMATxStop(RingBuffer *rb)
+{
+    int status;
+    uint32_t len = 0;
+
+    /* Park an idle engine, or take a busy one away from Complete (ERROR) */
+    while (!RB_ATOMIC_CAS(&rb->dmaState, RINGBUFFER_DMA_READY, RINGBUFFER_DMA_IDLE)) {
+        if (rb->dmaState != RINGBUFFER_DMA_BUSY) {
+            return RB_ERROR_INVALID;
+        }
+        if (RB_ATOMIC_CAS(&rb->dmaState, RINGBUFFER_DMA_BUSY, RINGBUFFER_DMA_ERROR)) {
+            break;
+        }
+    }
+    if (rb->dmaState == RINGBUFFER_DMA_IDLE) {
+        return RB_OK;
+    }
+
+    /* Was busy: halt the engine and release what it already sent */
+    status = _RingBufferDMAStopCall(rb);
+    if (status) {
+        rb->dmaState = RINGBUFFER_DMA_BUSY;
+        return status;
+    }
+
+    if (_RingBufferDMAHasRecvedLen(rb)) {
+        len = _RingBufferDMARecvedLenCall(rb);
+        if (len <= rb->blockSize) {
+            rb->head = (rb->head + len) % rb->size;
+            rb->totalOut += len;
+        }
+    }
+
+    rb->dmaState = RINGBUFFER_DMA_IDLE;
+
+    RB_TRACE4(dma_stop, rb, len, rb->head, (rb->tail + rb->size - rb->head) % rb->size);
+
+    return RB_OK;
+}
+
+static int _RingBufferDMATxComplete(RingBuffer *rb)
+{
+    uint32_t size = rb->blockSize;
+
+    if (rb->dmaState != RINGBUFFER_DMA_BUSY) {
+        return RB_ERROR_INVALID;
+    }
+
+    rb->head = (rb->head + size) % rb->size;
+    rb->totalOut += size;
+#if RINGBUFFER_USE_STATISTICS
+    rb->consStat.calls++;
+#endif  /* RINGBUFFER_USE_STATISTICS */
+
+    RB_TRACE4(dma_complete, rb, size, rb->head, (rb->tail + rb->size - rb->head) % rb->size);
+
+    /* Chain straight into the next block while data remains */
+    if (rb->tail != rb->head && !rb->cacheBatch && _RingBufferDMATxKick(rb) == RB_OK) {
+        return RB_OK;
+    }
+
+    rb->dmaState = RINGBUFFER_DMA_READY;
+
+    /* Pairs with the barrier in RingBufferPut, data may have landed meanwhile */
+    RB_MEMORY_BARRIER();
+    _RingBufferDMATxTryKick(rb);
+
+    return RB_OK;
 }
 
-#if RINGBUFFER_USE_DMA_MODE
+#if RINGBUFFER_DMA_STRIPE_CHANNELS
 
-#include <stdio.h>
-int RingBufferDMADeviceRegister(
+/*
+ * In striped mode dmaState stays BUSY: the channels own the write side,
+ * so the single-engine Config/Enqueue/Circular calls are refused.
+ */
+int RingBufferDMAStripeRegister(
     RingBuffer *rb,
-    RINGBUFFER_DMA_CONFIG DmaConfig,
-    RINGBUFFER_DMA_START DmaStart,
-    RINGBUFFER_DMA_STOP DmaStop,
-    RINGBUFFER_DMA_RECVED_LEN DmaRecvedLen,
+    const RingBufferDMAChannel *channel,
+    uint32_t num,
     RINGBUFFER_CLEAN_CHCHE CleanCache,
     RINGBUFFER_INVALID_CHCHE InvalidCache
 )
 {
-    if (rb == nullptr) {
+    uint32_t i;
+
+    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
         return RB_ERROR_PARAM;
     }
-    if (DmaConfig == nullptr || DmaRecvedLen == nullptr) {
+    if (channel == nullptr || num <= 0 || num > RINGBUFFER_DMA_STRIPE_CHANNELS) {
         return RB_ERROR_PARAM;
     }
+    for (i = 0; i < num; i++) {
+        if (channel[i].DmaConfig == nullptr && (channel[i].ops == nullptr || channel[i].ops->DmaConfig == nullptr)) {
+            return RB_ERROR_PARAM;
+        }
+    }
 
-    rb->dmaState = RINGBUFFER_DMA_IDLE;
     rb->srcAddr = 0;
-    rb->detAddr = (RB_ADDRESS)&rb->buff[0];
+    rb->detAddr = (RB_ADDRESS)&rb->buff[rb->tail];
     rb->blockSize = 0;
+    _RingBufferDMAModeQueueReset(rb);
 
-    rb->DmaConfig = DmaConfig;
-    rb->DmaStart = DmaStart;
-    rb->DmaStop = DmaStop;
-    rb->DmaRecvedLen = DmaRecvedLen;
+    for (i = 0; i < num; i++) {
+        rb->dmaChannel[i] = channel[i];
+    }
+    rb->dmaStripeTail = rb->tail;
+
+    _RingBufferDMACallbacksClear(rb);
     rb->CleanCache = CleanCache;
     rb->InvalidCache = InvalidCache;
 
-    RingBufferModeSwitchTo(rb, RINGBUFFER_DMA_MODE);
+    rb->cacheBatch = 0;
+    rb->cleanLen = 0;
+    rb->invalidUpTo = rb->totalOut;
+
+    rb->dmaChannelNum = num;
+    rb->dmaState = RINGBUFFER_DMA_BUSY;
+
+    return RingBufferModeSwitchTo(rb, RINGBUFFER_DMA_MODE);
+}
+
+int RingBufferDMAStripeStart(RingBuffer *rb, uint32_t ch, RB_ADDRESS src, uint32_t size)
+{
+    const RingBufferDMAChannel *channel;
+    RingBufferDMAStripe *stripe;
+    uint32_t in;
+    uint32_t reserve;
+    uint32_t offset;
+    uint32_t used;
+    int status;
+
+    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
+        return RB_ERROR_PARAM;
+    }
+    if (src == 0 || size <= 0 || size >= rb->size) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->mode != RINGBUFFER_DMA_MODE || ch >= rb->dmaChannelNum) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->dmaChannelSlot[ch]) {
+        return RB_ERROR_LOCKED;
+    }
+
+    in = rb->dmaStripeIn;
+    if (in - rb->dmaStripeOut >= RINGBUFFER_DMA_STRIPE_DEPTH) {
+        return RB_ERROR_LOCKED;
+    }
+
+    /* Unread data and the stripes in flight, everything from head on */
+    reserve = rb->dmaStripeTail;
+    offset = reserve;
+    used = (offset + rb->size - rb->head) % rb->size;
+    if (offset + size > rb->size) {
+        /* Too short to the right border, leave the rest unused and wrap */
+        used += rb->size - offset;
+        offset = 0;
+    }
+    if (size > rb->size - 1 - used) {
+        return RB_ERROR_LOCKED;
+    }
+
+    channel = &rb->dmaChannel[ch];
+    if (channel->ops) {
+        status = channel->ops->DmaConfig(channel->ctx, src, (RB_ADDRESS)&rb->buff[offset], size);
+    } else {
+        status = channel->DmaConfig(src, (RB_ADDRESS)&rb->buff[offset], size);
+    }
+    if (status) {
+        return status;
+    }
+
+    RB_TRACE4(dma_config, rb, src, (RB_ADDRESS)&rb->buff[offset], size);
+
+    stripe = &rb->dmaStripe[in % RINGBUFFER_DMA_STRIPE_DEPTH];
+    stripe->offset = offset;
+    stripe->size = size;
+    stripe->done = 0;
+    rb->dmaChannelSlot[ch] = in % RINGBUFFER_DMA_STRIPE_DEPTH + 1;
+
+    /* Publish before starting, the channel may complete right away */
+    RB_MEMORY_BARRIER();
+    rb->dmaStripeIn = in + 1;
+    rb->dmaStripeTail = (offset + size) % rb->size;
+
+    if (channel->ops) {
+        status = channel->ops->DmaStart ? channel->ops->DmaStart(channel->ctx) : RB_OK;
+    } else {
+        status = channel->DmaStart ? channel->DmaStart() : RB_OK;
+    }
+    if (status) {
+        /* Nothing was written, hand the region back */
+        rb->dmaChannelSlot[ch] = 0;
+        rb->dmaStripeTail = reserve;
+        rb->dmaStripeIn = in;
+        return status;
+    }
+
+    RB_TRACE4(dma_start, rb, (RB_ADDRESS)&rb->buff[offset], size, ch);
 
     return RB_OK;
 }
 
-int RingBufferDMADeviceUnregister(RingBuffer *rb)
+int RingBufferDMAStripeComplete(RingBuffer *rb, uint32_t ch)
 {
-    if (rb == nullptr) {
+    uint32_t slot;
+
+    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->mode != RINGBUFFER_DMA_MODE || ch >= rb->dmaChannelNum) {
         return RB_ERROR_PARAM;
     }
 
-    RingBufferDMAStop(rb);
+    slot = rb->dmaChannelSlot[ch];
+    if (slot == 0) {
+        return RB_ERROR_INVALID;
+    }
+    rb->dmaChannelSlot[ch] = 0;
 
-    rb->dmaState = RINGBUFFER_DMA_ERROR;
-    rb->srcAddr = 0;
-    rb->detAddr = 0;
-    rb->blockSize = 0;
+    rb->dmaStripe[slot - 1].done = 1;
+    RB_MEMORY_BARRIER();
 
-    rb->DmaConfig = nullptr;
-    rb->DmaStart = nullptr;
-    rb->DmaStop = nullptr;
-    rb->DmaRecvedLen = nullptr;
+    _RingBufferDMAStripeAdvance(rb, 0);
 
-    rb->CleanCache = nullptr;
-    rb->InvalidCache = nullptr;
+    return RB_OK;
+}
 
-    RingBufferModeSwitchTo(rb, RINGBUFFER_CPU_MODE);
+static int _RingBufferDMAStripeStop(RingBuffer *rb)
+{
+    uint32_t i;
+
+    for (i = 0; i < rb->dmaChannelNum; i++) {
+        if (rb->dmaChannel[i].ops) {
+            if (rb->dmaChannel[i].ops->DmaStop) {
+                rb->dmaChannel[i].ops->DmaStop(rb->dmaChannel[i].ctx);
+            }
+        } else if (rb->dmaChannel[i].DmaStop) {
+            rb->dmaChannel[i].DmaStop();
+        }
+        rb->dmaChannelSlot[i] = 0;
+    }
+
+    /* Stripes still in flight are dropped, reserve again from tail */
+    rb->dmaStripeOut = rb->dmaStripeIn;
+    rb->dmaStripeTail = rb->tail;
+    rb->dataHasPut = 1;
+
+    RB_TRACE4(dma_stop, rb, 0, rb->tail, rb->totalIn - rb->totalOut);
 
     return RB_OK;
 }
 
+#endif  /* RINGBUFFER_DMA_STRIPE_CHANNELS */
+
 int RingBufferDMAConfig(RingBuffer *rb, RB_ADDRESS src, uint32_t size)
 {
     int status;
@@ -399,91 +1538,210 @@ int RingBufferDMAConfig(RingBuffer *rb, RB_ADDRESS src, uint32_t size)
         return RB_ERROR_INVALID;
     }
 
+    if (rb->dmaQueueIn != rb->dmaQueueOut) {
+        /* Replace the blocks configured but not started yet */
+        _RingBufferDMAStopCall(rb);
+        rb->dmaQueueOut = rb->dmaQueueIn;
+        rb->dmaQueueDone = rb->dmaQueueIn;
+    }
+
     rb->srcAddr = src;
     rb->blockSize = size;
 
-    if (rb->DmaConfig) {
-        status = rb->DmaConfig(rb->srcAddr, rb->detAddr, rb->blockSize);
-        if (status) {
-            return status;
-        }
+    status = _RingBufferDMAConfigCall(rb, rb->srcAddr, rb->detAddr, rb->blockSize);
+    if (status) {
+        return status;
     }
 
+    _RingBufferDMAModeQueuePush(rb, rb->srcAddr, rb->detAddr, rb->blockSize);
+
     if (rb->dmaState == RINGBUFFER_DMA_IDLE) {
         rb->dmaState = RINGBUFFER_DMA_READY;
     }
 
+    RB_TRACE4(dma_config, rb, rb->srcAddr, rb->detAddr, rb->blockSize);
+
     return RB_OK;
 }
 
-int RingBufferDMAStart(RingBuffer *rb)
+/*
+ * Queue the next block behind the last configured one, so the engine can
+ * run straight into it without waiting for the completion irq to rearm.
+ * The driver's DmaConfig is called for every queued block and has to link
+ * it behind the previous one; DmaRecvedLen reports the running block.
+ */
+int RingBufferDMAEnqueue(RingBuffer *rb, RB_ADDRESS src, uint32_t size)
 {
+    const RingBufferDMADesc *last;
+    RB_ADDRESS det;
+    uint32_t in;
     int status;
 
     if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
         return RB_ERROR_PARAM;
     }
+    if (src == 0 || size <= 0) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->mode != RINGBUFFER_DMA_MODE) {
+        return RB_ERROR_PARAM;
+    }
+
+    in = rb->dmaQueueIn;
+    if (in == rb->dmaQueueOut) {
+        if (rb->dmaState == RINGBUFFER_DMA_BUSY) {
+            /* Last block is completing right now */
+            return RB_ERROR_LOCKED;
+        }
+        return RingBufferDMAConfig(rb, src, size);
+    }
+    if (in - rb->dmaQueueOut >= RINGBUFFER_DMA_QUEUE_DEPTH) {
+        return RB_ERROR_LOCKED;
+    }
+
+    last = &rb->dmaQueue[(in - 1) % RINGBUFFER_DMA_QUEUE_DEPTH];
+    det = last->det + last->size;
+    if (det >= (RB_ADDRESS)&rb->buff[0] + rb->size) {
+        det = (RB_ADDRESS)&rb->buff[0];
+    }
+    if (det + size > (RB_ADDRESS)&rb->buff[0] + rb->size) {
+        return RB_ERROR_PARAM;
+    }
+
+    status = _RingBufferDMAConfigCall(rb, src, det, size);
+    if (status) {
+        return status;
+    }
+
+    _RingBufferDMAModeQueuePush(rb, src, det, size);
+
+    RB_TRACE4(dma_config, rb, src, det, size);
+
+    RB_MEMORY_BARRIER();
+    if (rb->dmaQueueOut == in && rb->dmaQueueDone == in && rb->dmaState == RINGBUFFER_DMA_READY) {
+        /* The block ahead retired and Complete found no successor, start us */
+        return RingBufferDMAStart(rb);
+    }
+    /* Complete still running (maybe preempted by us) picks the block up itself */
+
+    return RB_OK;
+}
+
+static int _RingBufferDMAModeStart(RingBuffer *rb)
+{
+    int status;
+
     if (rb->dmaState != RINGBUFFER_DMA_READY) {
         return RB_ERROR_INVALID;
     }
+    if (rb->dmaQueueIn == rb->dmaQueueOut) {
+        return RB_ERROR_INVALID;
+    }
 
-    if (rb->DmaStart) {
-        status = rb->DmaStart();
-        if (status) {
-            return status;
-        }
+    _RingBufferDMAModeLoadDesc(rb, &rb->dmaQueue[rb->dmaQueueOut % RINGBUFFER_DMA_QUEUE_DEPTH]);
+
+    status = _RingBufferDMAStartCall(rb);
+    if (status) {
+        return status;
     }
 
     rb->dmaState = RINGBUFFER_DMA_BUSY;
 
+    RB_TRACE4(dma_start, rb, rb->detAddr, rb->blockSize, rb->tail);
+
     return RB_OK;
 }
 
+int RingBufferDMAStart(RingBuffer *rb)
+{
+    int status;
+
+    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
+        return RB_ERROR_PARAM;
+    }
+    /* Enqueue and Complete may both find a stranded block, one of them starts it */
+    if (!RB_ATOMIC_CAS(&rb->dmaStartLock, 0U, 1U)) {
+        return RB_OK;
+    }
+
+    status = _RingBufferDMAModeStart(rb);
+
+    RB_MEMORY_BARRIER();
+    rb->dmaStartLock = 0;
+
+    return status;
+}
+
 int RingBufferDMAStop(RingBuffer *rb)
 {
     int status;
-    uint32_t len;
+    uint32_t len = 0;
 
     if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
         return RB_ERROR_PARAM;
     }
+    if (rb->mode == RINGBUFFER_DMA_TX_MODE) {
+        return _RingBufferDMATxStop(rb);
+    }
+#if RINGBUFFER_DMA_STRIPE_CHANNELS
+    if (rb->dmaChannelNum) {
+        return _RingBufferDMAStripeStop(rb);
+    }
+#endif  /* RINGBUFFER_DMA_STRIPE_CHANNELS */
     if (rb->dmaState != RINGBUFFER_DMA_BUSY) {
         return RB_ERROR_INVALID;
     }
 
-    if (rb->DmaStop) {
-        status = rb->DmaStop();
-        if (status) {
-            return status;
-        }
+    status = _RingBufferDMAStopCall(rb);
+    if (status) {
+        return status;
     }
 
     _RingBufferDMAModeUpdateLen(rb);
 
     rb->dataHasPut = 1;
 
-    if (rb->DmaRecvedLen) {
-        len = rb->DmaRecvedLen();
+#if RINGBUFFER_USE_DMA_CIRCULAR
+    if (rb->dmaCircular) {
+        len = (rb->tail + rb->size - rb->dmaEventPos) % rb->size;
+        rb->dmaEventPos = rb->tail;
+        _RingBufferDMAModeAccount(rb, len);
+        /* The engine stands still, everything but the byte at tail is valid */
+        _RingBufferDMACircularOverrun(rb, (rb->tail + 1) % rb->size);
+        rb->dmaCircular = 0;
+        rb->dmaEventPos = 0;
+    } else
+#endif  /* RINGBUFFER_USE_DMA_CIRCULAR */
+    if (_RingBufferDMAHasRecvedLen(rb)) {
+        len = _RingBufferDMARecvedLenCall(rb);
         if (len < rb->blockSize) {
-            rb->totalIn += len;
-#if RINGBUFFER_USE_RX_OVERFLOW
-            if (_RingBufferDMAModeCheckOverflow(rb)) {
-                rb->overflowTimes++;
-            }
-#endif
+            _RingBufferDMAModeAccount(rb, len);
         }
     }
 
+    /* Drop the queued blocks, the next one starts where this one stopped */
+    rb->dmaQueueOut = rb->dmaQueueIn;
+    rb->detAddr = (RB_ADDRESS)&rb->buff[rb->tail];
+
     rb->dmaState = RINGBUFFER_DMA_READY;
+    rb->dmaQueueDone = rb->dmaQueueOut;
+
+    RB_TRACE4(dma_stop, rb, len, rb->tail, rb->totalIn - rb->totalOut);
 
     return RB_OK;
 }
 
 int RingBufferDMAComplete(RingBuffer *rb)
 {
+    const RingBufferDMADesc *desc;
+    uint32_t out;
+
     if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
         return RB_ERROR_PARAM;
     }
+    if (rb->mode == RINGBUFFER_DMA_TX_MODE) {
+        return _RingBufferDMATxComplete(rb);
+    }
     if (rb->mode != RINGBUFFER_DMA_MODE) {
         return RB_ERROR_PARAM;
     }
@@ -491,20 +1749,184 @@ int RingBufferDMAComplete(RingBuffer *rb)
         return RB_ERROR_INVALID;
     }
 
+#if RINGBUFFER_USE_DMA_CIRCULAR
+    if (rb->dmaCircular) {
+        uint32_t len;
+
+        /* Transfer complete: the engine wrapped, account the rest of the lap */
+        _RingBufferDMAModeUpdateLen(rb);
+        len = rb->size - rb->dmaEventPos;
+        rb->dmaEventPos = 0;
+        _RingBufferDMAModeAccount(rb, len);
+        /* Keep the half just completed, the engine is overwriting the other one */
+        _RingBufferDMACircularOverrun(rb, rb->size / 2);
+
+        RB_TRACE4(dma_complete, rb, rb->size, rb->tail, _RingBufferDMAModeUnread(rb));
+
+        return RB_OK;
+    }
+#endif  /* RINGBUFFER_USE_DMA_CIRCULAR */
+
+    out = rb->dmaQueueOut;
+    if (out == rb->dmaQueueIn) {
+        return RB_ERROR_INVALID;
+    }
+    desc = &rb->dmaQueue[out % RINGBUFFER_DMA_QUEUE_DEPTH];
+
+    /* DmaRecvedLen may already count the next queued block, use the descriptor */
+    rb->tail = (desc->det - (RB_ADDRESS)&rb->buff[0] + desc->size) % rb->size;
+
+    _RingBufferDMAModeAccount(rb, desc->size);
+
+    RB_TRACE4(dma_complete, rb, desc->size, rb->tail, rb->totalIn - rb->totalOut);
+
+    /* Retire the block before looking for a successor, pairs with Enqueue */
+    rb->dmaQueueOut = ++out;
+    RB_MEMORY_BARRIER();
+
+    if (out != rb->dmaQueueIn) {
+        /* The engine has already moved on to the next queued block */
+        _RingBufferDMAModeLoadDesc(rb, &rb->dmaQueue[out % RINGBUFFER_DMA_QUEUE_DEPTH]);
+    } else {
+        rb->detAddr = (RB_ADDRESS)&rb->buff[rb->tail];
+        rb->dmaState = RINGBUFFER_DMA_READY;
+    }
+
+    RB_MEMORY_BARRIER();
+    rb->dmaQueueDone = out;
+
+    /* An Enqueue that saw us half way left its block to us, pairs with Enqueue */
+    RB_MEMORY_BARRIER();
+    if (rb->dmaState == RINGBUFFER_DMA_READY && rb->dmaQueueIn != out) {
+        return RingBufferDMAStart(rb);
+    }
+
+    return RB_OK;
+}
+
+#if RINGBUFFER_USE_DMA_CIRCULAR
+
+int RingBufferDMACircularStart(RingBuffer *rb, RB_ADDRESS src)
+{
+    int status;
+
+    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
+        return RB_ERROR_PARAM;
+    }
+    if (src == 0) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->mode != RINGBUFFER_DMA_MODE) {
+        return RB_ERROR_PARAM;
+    }
+    if ((rb->dmaState != RINGBUFFER_DMA_READY) && (rb->dmaState != RINGBUFFER_DMA_IDLE)) {
+        return RB_ERROR_INVALID;
+    }
+    /* The engine always starts at the buffer base */
+    if (RingBufferLenGet(rb) != 0) {
+        return RB_ERROR_INVALID;
+    }
+
+    if (rb->dmaQueueIn != rb->dmaQueueOut) {
+        _RingBufferDMAStopCall(rb);
+        rb->dmaQueueOut = rb->dmaQueueIn;
+        rb->dmaQueueDone = rb->dmaQueueIn;
+    }
+
+    rb->head = 0;
+    rb->tail = 0;
+
+    rb->srcAddr = src;
+    rb->detAddr = (RB_ADDRESS)&rb->buff[0];
+    rb->blockSize = rb->size;
+
+    status = _RingBufferDMAConfigCall(rb, rb->srcAddr, rb->detAddr, rb->blockSize);
+    if (status) {
+        return status;
+    }
+
+    RB_TRACE4(dma_config, rb, rb->srcAddr, rb->detAddr, rb->blockSize);
+
+    status = _RingBufferDMAStartCall(rb);
+    if (status) {
+        return status;
+    }
+
+    rb->dmaEventPos = 0;
+    rb->dmaCircular = 1;
+    rb->dmaState = RINGBUFFER_DMA_BUSY;
+
+    RB_TRACE4(dma_start, rb, rb->detAddr, rb->blockSize, rb->tail);
+
+    return RB_OK;
+}
+
+int RingBufferDMAHalfComplete(RingBuffer *rb)
+{
+    uint32_t half;
+    uint32_t len;
+
+    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->mode != RINGBUFFER_DMA_MODE) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->dmaState != RINGBUFFER_DMA_BUSY || !rb->dmaCircular) {
+        return RB_ERROR_INVALID;
+    }
+
+    half = rb->size / 2;
+    if (rb->dmaEventPos >= half) {
+        /* Already accounted, the irq fired twice */
+        return RB_OK;
+    }
+
     _RingBufferDMAModeUpdateLen(rb);
+    len = half - rb->dmaEventPos;
+    rb->dmaEventPos = half;
+    _RingBufferDMAModeAccount(rb, len);
+    _RingBufferDMACircularOverrun(rb, 0);
 
-    rb->dataHasPut = 1;
+    RB_TRACE4(dma_complete, rb, half, rb->tail, _RingBufferDMAModeUnread(rb));
 
-    rb->detAddr = (RB_ADDRESS)&rb->buff[rb->tail];
+    return RB_OK;
+}
 
-    rb->totalIn += rb->blockSize;
-#if RINGBUFFER_USE_RX_OVERFLOW
-    if (_RingBufferDMAModeCheckOverflow(rb)) {
-        rb->overflowTimes++;
+#endif  /* RINGBUFFER_USE_DMA_CIRCULAR */
+
+int RingBufferCacheBatchBegin(RingBuffer *rb)
+{
+    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->cacheBatch) {
+        return RB_ERROR_LOCKED;
     }
-#endif
 
-    rb->dmaState = RINGBUFFER_DMA_READY;
+    rb->cacheBatch = 1;
+
+    return RB_OK;
+}
+
+int RingBufferCacheBatchEnd(RingBuffer *rb)
+{
+    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
+        return RB_ERROR_PARAM;
+    }
+    if (!rb->cacheBatch) {
+        return RB_ERROR_UNLOCKED;
+    }
+
+    if (_RingBufferHasCleanCache(rb)) {
+        _RingBufferCacheCleanFlush(rb);
+    }
+    rb->cacheBatch = 0;
+
+    if (rb->mode == RINGBUFFER_DMA_TX_MODE) {
+        RB_MEMORY_BARRIER();
+        _RingBufferDMATxTryKick(rb);
+    }
 
     return RB_OK;
 }
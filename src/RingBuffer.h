@@ -12,7 +12,7 @@ extern "C" {
 #include "port/port.h"
 
 #ifndef RB_ADDRESS
-#if _WIN64
+#if _WIN64 || defined(__LP64__)
 #define RB_ADDRESS uint64_t
 #else
 #define RB_ADDRESS uint32_t
@@ -32,6 +32,7 @@ typedef enum {
     RINGBUFFER_INVALID_MODE = 0U,
     RINGBUFFER_CPU_MODE,
     RINGBUFFER_DMA_MODE,
+    RINGBUFFER_DMA_TX_MODE,
     RINGBUFFER_MODE_MAX
 } RingBufferMode;
 
@@ -49,11 +50,98 @@ typedef int (*RINGBUFFER_DMA_START)(void);
 typedef int (*RINGBUFFER_DMA_STOP)(void);
 typedef uint32_t (*RINGBUFFER_DMA_RECVED_LEN)(void);
 
-typedef void (*RINGBUFFER_CLEAN_CHCHE)(uint32_t start_addr, uint32_t size);
-typedef void (*RINGBUFFER_INVALID_CHCHE)(uint32_t start_addr, uint32_t size);
+/* Ranges are aligned to RINGBUFFER_CACHE_LINE_SIZE, keep dma buffers line aligned */
+typedef void (*RINGBUFFER_CLEAN_CHCHE)(RB_ADDRESS start_addr, uint32_t size);
+typedef void (*RINGBUFFER_INVALID_CHCHE)(RB_ADDRESS start_addr, uint32_t size);
+
+/* Same callbacks with a per-instance context, for drivers serving many rings */
+typedef int (*RINGBUFFER_DMA_CONFIG_EX)(void *ctx, RB_ADDRESS src, RB_ADDRESS det, uint32_t size);
+typedef int (*RINGBUFFER_DMA_START_EX)(void *ctx);
+typedef int (*RINGBUFFER_DMA_STOP_EX)(void *ctx);
+typedef uint32_t (*RINGBUFFER_DMA_RECVED_LEN_EX)(void *ctx);
+
+typedef void (*RINGBUFFER_CLEAN_CHCHE_EX)(void *ctx, RB_ADDRESS start_addr, uint32_t size);
+typedef void (*RINGBUFFER_INVALID_CHCHE_EX)(void *ctx, RB_ADDRESS start_addr, uint32_t size);
+
+typedef struct {
+    RINGBUFFER_DMA_CONFIG_EX DmaConfig;
+    RINGBUFFER_DMA_START_EX DmaStart;
+    RINGBUFFER_DMA_STOP_EX DmaStop;
+    RINGBUFFER_DMA_RECVED_LEN_EX DmaRecvedLen;
+
+    RINGBUFFER_CLEAN_CHCHE_EX CleanCache;
+    RINGBUFFER_INVALID_CHCHE_EX InvalidCache;
+} RingBufferDMAOps;
+
+typedef struct {
+    RB_ADDRESS src;
+    RB_ADDRESS det;
+    uint32_t size;
+} RingBufferDMADesc;
+
+#if RINGBUFFER_DMA_STRIPE_CHANNELS
+
+typedef struct {
+    RINGBUFFER_DMA_CONFIG DmaConfig;
+    RINGBUFFER_DMA_START DmaStart;
+    RINGBUFFER_DMA_STOP DmaStop;
+
+    /* Used instead of the callbacks above when set */
+    const RingBufferDMAOps *ops;
+    void *ctx;
+} RingBufferDMAChannel;
+
+typedef struct {
+    uint32_t offset;
+    uint32_t size;
+    volatile uint32_t done;
+} RingBufferDMAStripe;
+
+#endif  /* RINGBUFFER_DMA_STRIPE_CHANNELS */
 
 #endif  /* RINGBUFFER_USE_DMA_MODE */
 
+#if RINGBUFFER_USE_STATISTICS
+
+/* Written only by the producer side (RingBufferPut / DMA irq) */
+typedef struct {
+    volatile uint64_t calls;
+    volatile uint64_t fullTimes;
+    volatile uint64_t shortTimes;
+    volatile uint64_t truncatedBytes;
+    volatile uint32_t highWaterMark;
+    uint64_t baseIn;                    // totalIn at the last reset
+} RingBufferProducerStat;
+
+/* Written only by the consumer side (RingBufferGet) */
+typedef struct {
+    volatile uint64_t calls;
+    volatile uint64_t emptyTimes;
+    uint64_t baseOut;                   // totalOut at the last reset
+} RingBufferConsumerStat;
+
+typedef struct {
+    uint32_t size;
+    uint32_t len;
+    uint32_t highWaterMark;     // Max occupancy seen since init or reset
+
+    uint64_t totalIn;
+    uint64_t totalOut;
+    uint64_t overflowTimes;
+
+    uint64_t putCalls;          // RingBufferPut calls, or completed dma blocks
+    uint64_t getCalls;
+    uint64_t fullTimes;         // Put found no free space at all
+    uint64_t emptyTimes;        // Get found no data at all
+    uint64_t shortTimes;        // Put was truncated to the free space
+    uint64_t truncatedBytes;    // Bytes refused by Put (full or truncated)
+
+    uint32_t avgPutSize;        // Since init or reset
+    uint32_t avgGetSize;
+} RingBufferStatistics;
+
+#endif  /* RINGBUFFER_USE_STATISTICS */
+
 typedef struct {
     uint8_t *buff;
     uint32_t size;
@@ -70,6 +158,30 @@ typedef struct {
     volatile RB_ADDRESS srcAddr;
     volatile RB_ADDRESS detAddr;
     volatile uint32_t blockSize;
+
+    /* Blocks handed to the dma driver, dmaQueue[dmaQueueOut] is the running one */
+    RingBufferDMADesc dmaQueue[RINGBUFFER_DMA_QUEUE_DEPTH];
+    volatile uint32_t dmaQueueIn;       // Producer side: Config/Enqueue
+    volatile uint32_t dmaQueueOut;      // Irq side: Complete/Stop
+    volatile uint32_t dmaQueueDone;     // dmaQueueOut once Complete has settled dmaState
+    uint64_t dmaRecvedPos;              // Stream position of the tail taken from DmaRecvedLen
+    volatile uint32_t dmaStartLock;     // Held by whoever is starting a READY engine
+
+#if RINGBUFFER_USE_DMA_CIRCULAR
+    volatile uint32_t dmaCircular;
+    volatile uint32_t dmaEventPos;      // Position accounted into totalIn at the last HT/TC event
+#endif  /* RINGBUFFER_USE_DMA_CIRCULAR */
+
+#if RINGBUFFER_DMA_STRIPE_CHANNELS
+    RingBufferDMAChannel dmaChannel[RINGBUFFER_DMA_STRIPE_CHANNELS];
+    uint32_t dmaChannelNum;             // Non-zero in striped mode
+    volatile uint32_t dmaChannelSlot[RINGBUFFER_DMA_STRIPE_CHANNELS];   // Stripe index + 1, 0 when idle
+    RingBufferDMAStripe dmaStripe[RINGBUFFER_DMA_STRIPE_DEPTH];
+    volatile uint32_t dmaStripeIn;      // Producer side: StripeStart
+    volatile uint32_t dmaStripeOut;     // Owner of dmaStripeLock
+    volatile uint32_t dmaStripeLock;
+    uint32_t dmaStripeTail;             // Where the next stripe is reserved
+#endif  /* RINGBUFFER_DMA_STRIPE_CHANNELS */
 #endif  /* RINGBUFFER_USE_DMA_MODE */
 
 #if RINGBUFFER_USE_RX_OVERFLOW
@@ -78,6 +190,19 @@ typedef struct {
     uint64_t totalIn;
     uint64_t totalOut;
 
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+    uint32_t publishEvery;              // 0 publishes tail on every put
+    uint32_t pendTail;                  // Producer-private tail, pendLen ahead of tail
+    uint32_t pendLen;
+    volatile uint32_t consumerWaiting;  // Set by a get that found the ring empty
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+
+#if RINGBUFFER_USE_STATISTICS
+    /* Keep producer and consumer counters on separate cache lines */
+    RB_ALIGNED(RINGBUFFER_CACHE_LINE_SIZE) RingBufferProducerStat prodStat;
+    RB_ALIGNED(RINGBUFFER_CACHE_LINE_SIZE) RingBufferConsumerStat consStat;
+#endif  /* RINGBUFFER_USE_STATISTICS */
+
 #if RINGBUFFER_USE_DMA_MODE
     RINGBUFFER_DMA_CONFIG DmaConfig;
     RINGBUFFER_DMA_START DmaStart;
@@ -86,6 +211,15 @@ typedef struct {
 
     RINGBUFFER_CLEAN_CHCHE CleanCache;
     RINGBUFFER_INVALID_CHCHE InvalidCache;
+
+    /* Context flavour, takes precedence over the callbacks above */
+    const RingBufferDMAOps *dmaOps;
+    void *dmaCtx;
+
+    volatile uint32_t cacheBatch;
+    uint32_t cleanStart;                // Pending clean range inside the batch
+    uint32_t cleanLen;
+    uint64_t invalidUpTo;               // Data before this totalOut position is already invalidated
 #endif  /* RINGBUFFER_USE_DMA_MODE */
 } RingBuffer;
 
@@ -98,13 +232,43 @@ int RingBufferDeinit(RingBuffer *rb);
 
 uint32_t RingBufferLenGet(RingBuffer *rb);
 uint32_t RingBufferSizeGet(RingBuffer *rb);
+uint32_t RingBufferSpaceGet(RingBuffer *rb);  // Producer side, unpublished bytes count as used
 uint64_t RingBufferTotalInGet(RingBuffer *rb);
 uint64_t RingBufferTotalOutGet(RingBuffer *rb);
 uint64_t RingBufferOverflowTimesGet(RingBuffer *rb);
 
+#if RINGBUFFER_USE_STATISTICS
+int RingBufferStatisticsGet(RingBuffer *rb, RingBufferStatistics *stat);
+int RingBufferStatisticsReset(RingBuffer *rb);
+#endif  /* RINGBUFFER_USE_STATISTICS */
+
 uint32_t RingBufferPut(RingBuffer *rb, uint8_t *data, uint32_t size);
 uint32_t RingBufferGet(RingBuffer *rb, uint8_t *data, uint32_t size);
 
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+/*
+ * Deferred publish for small cpu mode puts: data is written at once but
+ * tail only moves every `bytes` bytes, when a get has found the ring empty
+ * since the last publish, or at RingBufferFlush(). Flush before the
+ * producer goes idle. 0 switches back to publishing on every put.
+ * Modules on top of a ring size their puts with RingBufferSpaceGet();
+ * RingBufferBroadcast moves tail itself and refuses a batched ring.
+ */
+int RingBufferPublishBatchSet(RingBuffer *rb, uint32_t bytes);
+int RingBufferFlush(RingBuffer *rb);
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+
+/*
+ * Move up to `size` bytes from `src` into `det` in one pass, segment by
+ * segment across the wrap of both rings, without a scratch buffer. `src`
+ * is consumed as by RingBufferGet() and `det` filled as by RingBufferPut(),
+ * cache maintenance, tx kick and deferred publish included. A non-null
+ * `cb` sees each moved segment in place in `det` before it is published
+ * and may rewrite it.
+ */
+typedef void (*RINGBUFFER_TRANSFER_CB)(void *arg, uint8_t *data, uint32_t size);
+uint32_t RingBufferTransfer(RingBuffer *det, RingBuffer *src, uint32_t size, RINGBUFFER_TRANSFER_CB cb, void *arg);
+
 #if RINGBUFFER_USE_DMA_MODE
 
 int RingBufferDMADeviceRegister(
@@ -116,13 +280,76 @@ int RingBufferDMADeviceRegister(
     RINGBUFFER_CLEAN_CHCHE CleanCache,
     RINGBUFFER_INVALID_CHCHE InvalidCache
 );
+int RingBufferDMADeviceRegisterEx(RingBuffer *rb, const RingBufferDMAOps *ops, void *ctx);  // ctx nullptr passes rb
 int RingBufferDMADeviceUnregister(RingBuffer *rb);
 
+/*
+ * Transmit direction: the cpu fills the ring with RingBufferPut() and the
+ * library drains it with dma reads from head to the peripheral at `det`,
+ * in the largest contiguous blocks available. RingBufferDMAComplete()
+ * advances head and chains the next block while data remains.
+ */
+int RingBufferDMATxDeviceRegister(
+    RingBuffer *rb,
+    RINGBUFFER_DMA_CONFIG DmaConfig,
+    RINGBUFFER_DMA_START DmaStart,
+    RINGBUFFER_DMA_STOP DmaStop,
+    RINGBUFFER_DMA_RECVED_LEN DmaRecvedLen,
+    RINGBUFFER_CLEAN_CHCHE CleanCache,
+    RINGBUFFER_INVALID_CHCHE InvalidCache
+);
+int RingBufferDMATxDeviceRegisterEx(RingBuffer *rb, const RingBufferDMAOps *ops, void *ctx);
+int RingBufferDMATxStart(RingBuffer *rb, RB_ADDRESS det);
+
+#if RINGBUFFER_DMA_STRIPE_CHANNELS
+/*
+ * Striped mode: several dma channels fill consecutive regions of the ring
+ * at the same time. RingBufferDMAStripeStart() reserves the next region
+ * for channel `ch` and starts it; completions may arrive in any order but
+ * tail only moves over the contiguous prefix of finished stripes. It
+ * returns RB_ERROR_LOCKED while unread data and the stripes in flight
+ * leave too little room. A stripe too long for the rest of the ring starts
+ * at offset 0, RingBufferGet() skips the unused end once it reaches it.
+ */
+int RingBufferDMAStripeRegister(
+    RingBuffer *rb,
+    const RingBufferDMAChannel *channel,
+    uint32_t num,
+    RINGBUFFER_CLEAN_CHCHE CleanCache,
+    RINGBUFFER_INVALID_CHCHE InvalidCache
+);
+int RingBufferDMAStripeStart(RingBuffer *rb, uint32_t ch, RB_ADDRESS src, uint32_t size);
+int RingBufferDMAStripeComplete(RingBuffer *rb, uint32_t ch);  // Call at channel ch complete irq
+#endif  /* RINGBUFFER_DMA_STRIPE_CHANNELS */
+
+/*
+ * Merge the cache clean of consecutive RingBufferPut() calls into one
+ * aligned operation at RingBufferCacheBatchEnd(). In tx mode the data is
+ * handed to the dma at batch end too. Invalidation on the Get side is
+ * coalesced without a batch: the whole readable region is invalidated
+ * once and later gets inside it skip the callback.
+ */
+int RingBufferCacheBatchBegin(RingBuffer *rb);
+int RingBufferCacheBatchEnd(RingBuffer *rb);
+
 int RingBufferDMAConfig(RingBuffer *rb, RB_ADDRESS src, uint32_t size);
+int RingBufferDMAEnqueue(RingBuffer *rb, RB_ADDRESS src, uint32_t size);
 int RingBufferDMAStart(RingBuffer *rb);
 int RingBufferDMAStop(RingBuffer *rb);
 int RingBufferDMAComplete(RingBuffer *rb);  // Call at dma complete irq
 
+#if RINGBUFFER_USE_DMA_CIRCULAR
+/*
+ * Circular mode: the engine is armed once over the whole buffer and wraps
+ * by itself. DmaRecvedLen must return the write position in the buffer,
+ * i.e. size minus the remaining count. Call RingBufferDMAHalfComplete() at
+ * the half-transfer irq and RingBufferDMAComplete() at the transfer-complete
+ * irq; RingBufferDMAStop() ends circular mode.
+ */
+int RingBufferDMACircularStart(RingBuffer *rb, RB_ADDRESS src);
+int RingBufferDMAHalfComplete(RingBuffer *rb);  // Call at dma half transfer irq
+#endif  /* RINGBUFFER_USE_DMA_CIRCULAR */
+
 uint32_t RingBufferTailToRightBorderLenGet(RingBuffer *rb);
 int RingBufferDataCrossedRightBorder(RingBuffer *rb);
 
@@ -0,0 +1,186 @@
+#include "RingBuffer64.h"
+
+#if RINGBUFFER_USE_64BIT && UINTPTR_MAX > 0xFFFFFFFFU
+
+#ifndef nullptr
+#ifdef NULL
+#define nullptr NULL
+#else
+#define nullptr ((void *)0)
+#endif
+#endif
+
+int RingBuffer64Create(RingBuffer64 *rb, uint64_t size)
+{
+    uint8_t *buff = nullptr;
+
+    if (rb == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+    if (size <= 0) {
+        return RB_ERROR_PARAM;
+    }
+
+    buff = (uint8_t *)RB_MALLOC(size);
+    if (buff == nullptr) {
+        return RB_ERROR_MEMORY;
+    }
+
+    return RingBuffer64Init(rb, buff, size);
+}
+
+int RingBuffer64Delete(RingBuffer64 *rb)
+{
+    if (rb == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    if (rb->buff) {
+        RB_FREE(rb->buff);
+    }
+
+    return RingBuffer64Deinit(rb);
+}
+
+int RingBuffer64Init(RingBuffer64 *rb, uint8_t *buff, uint64_t size)
+{
+    if (rb == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+    if (buff == nullptr || size <= 0) {
+        return RB_ERROR_PARAM;
+    }
+
+    rb->buff = buff;
+    rb->size = size;
+    rb->head = 0;
+    rb->tail = 0;
+
+    return RB_OK;
+}
+
+int RingBuffer64Deinit(RingBuffer64 *rb)
+{
+    if (rb == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    rb->buff = nullptr;
+    rb->size = 0;
+    rb->head = 0;
+    rb->tail = 0;
+
+    return RB_OK;
+}
+
+uint64_t RingBuffer64LenGet(RingBuffer64 *rb)
+{
+    if (rb == nullptr || rb->size <= 0) {
+        return 0;
+    }
+
+    return rb->tail - rb->head;
+}
+
+uint64_t RingBuffer64SizeGet(RingBuffer64 *rb)
+{
+    if (rb == nullptr) {
+        return 0;
+    }
+
+    return rb->size;
+}
+
+uint64_t RingBuffer64TotalInGet(RingBuffer64 *rb)
+{
+    if (rb == nullptr) {
+        return 0;
+    }
+
+    return rb->tail;
+}
+
+uint64_t RingBuffer64TotalOutGet(RingBuffer64 *rb)
+{
+    if (rb == nullptr) {
+        return 0;
+    }
+
+    return rb->head;
+}
+
+uint64_t RingBuffer64Put(RingBuffer64 *rb, const uint8_t *data, uint64_t size)
+{
+    uint64_t tail;
+    uint64_t off;
+    uint64_t space;
+
+    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
+        return 0;
+    }
+    if (data == nullptr || size <= 0) {
+        return 0;
+    }
+
+    tail = rb->tail;
+    space = rb->size - (tail - rb->head);
+    if (size > space) {
+        size = space;
+    }
+    if (size == 0) {
+        return 0;
+    }
+
+    off = tail % rb->size;
+    if (off + size <= rb->size) {
+        RB_MEMCPY(&rb->buff[off], &data[0], size);
+    } else {
+        RB_MEMCPY(&rb->buff[off], &data[0], rb->size - off);
+        RB_MEMCPY(&rb->buff[0], &data[rb->size - off], size - (rb->size - off));
+    }
+
+    RB_PUBLISH_BARRIER();
+    rb->tail = tail + size;
+
+    return size;
+}
+
+uint64_t RingBuffer64Get(RingBuffer64 *rb, uint8_t *data, uint64_t size)
+{
+    uint64_t head;
+    uint64_t off;
+    uint64_t len;
+
+    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
+        return 0;
+    }
+    if (data == nullptr || size <= 0) {
+        return 0;
+    }
+
+    head = rb->head;
+    len = rb->tail - head;
+    /* Data behind tail is complete */
+    RB_PUBLISH_BARRIER();
+    if (size > len) {
+        size = len;
+    }
+    if (size == 0) {
+        return 0;
+    }
+
+    off = head % rb->size;
+    if (off + size <= rb->size) {
+        RB_MEMCPY(&data[0], &rb->buff[off], size);
+    } else {
+        RB_MEMCPY(&data[0], &rb->buff[off], rb->size - off);
+        RB_MEMCPY(&data[rb->size - off], &rb->buff[0], size - (rb->size - off));
+    }
+
+    RB_PUBLISH_BARRIER();
+    rb->head = head + size;
+
+    return size;
+}
+
+#endif  /* RINGBUFFER_USE_64BIT && UINTPTR_MAX > 0xFFFFFFFFU */
@@ -0,0 +1,49 @@
+#ifndef __RINGBUFFER64_H__
+#define __RINGBUFFER64_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "RingBuffer.h"
+
+#if RINGBUFFER_USE_64BIT && UINTPTR_MAX > 0xFFFFFFFFU
+
+/*
+ * Cpu mode ring with 64-bit size, positions and lengths, for buffers past
+ * 4 GB. Same single producer / single consumer contract as RingBuffer.
+ *
+ * head and tail are free-running stream positions (they double as
+ * totalOut/totalIn) and are reduced modulo size only to address the
+ * buffer. The length is tail - head without a wrap case, and all `size`
+ * bytes are usable, none is kept free to tell full from empty.
+ */
+
+typedef struct {
+    uint8_t *buff;
+    uint64_t size;
+
+    RB_ALIGNED(RINGBUFFER_CACHE_LINE_SIZE) volatile uint64_t tail;     // Written by the producer
+    RB_ALIGNED(RINGBUFFER_CACHE_LINE_SIZE) volatile uint64_t head;     // Written by the consumer
+} RingBuffer64;
+
+int RingBuffer64Create(RingBuffer64 *rb, uint64_t size);
+int RingBuffer64Delete(RingBuffer64 *rb);
+int RingBuffer64Init(RingBuffer64 *rb, uint8_t *buff, uint64_t size);
+int RingBuffer64Deinit(RingBuffer64 *rb);
+
+uint64_t RingBuffer64LenGet(RingBuffer64 *rb);
+uint64_t RingBuffer64SizeGet(RingBuffer64 *rb);
+uint64_t RingBuffer64TotalInGet(RingBuffer64 *rb);
+uint64_t RingBuffer64TotalOutGet(RingBuffer64 *rb);
+
+uint64_t RingBuffer64Put(RingBuffer64 *rb, const uint8_t *data, uint64_t size);
+uint64_t RingBuffer64Get(RingBuffer64 *rb, uint8_t *data, uint64_t size);
+
+#endif  /* RINGBUFFER_USE_64BIT && UINTPTR_MAX > 0xFFFFFFFFU */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__RINGBUFFER64_H__
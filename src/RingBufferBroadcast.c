@@ -0,0 +1,328 @@
+#include "RingBufferBroadcast.h"
+
+#if RINGBUFFER_USE_BROADCAST
+
+#ifndef nullptr
+#ifdef NULL
+#define nullptr NULL
+#else
+#define nullptr ((void *)0)
+#endif
+#endif
+
+#define BROADCAST_READER_FREE           0U
+#define BROADCAST_READER_ACTIVE         1U
+#define BROADCAST_READER_CLAIMED        2U
+
+static uint32_t _BroadcastOffset(RingBufferBroadcast *bc, uint64_t pos)
+{
+    uint32_t size = bc->rb->size;
+
+    return (uint32_t)((bc->baseOff + pos % size) % size);
+}
+
+static RingBufferBroadcastReader *_BroadcastReader(RingBufferBroadcast *bc, uint32_t id)
+{
+    if (bc == nullptr || bc->rb == nullptr || id >= RINGBUFFER_BROADCAST_READERS) {
+        return nullptr;
+    }
+    if (bc->reader[id].active != BROADCAST_READER_ACTIVE) {
+        return nullptr;
+    }
+
+    return &bc->reader[id];
+}
+
+int RingBufferBroadcastCreate(RingBufferBroadcast *bc, RingBuffer *rb, uint32_t lagLimit)
+{
+    if (bc == nullptr || rb == nullptr || rb->buff == nullptr || rb->size <= 1) {
+        return RB_ERROR_PARAM;
+    }
+    if (lagLimit >= rb->size) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->mode != RINGBUFFER_CPU_MODE) {
+        return RB_ERROR_INVALID;
+    }
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+    /* Put mirrors tail and totalIn itself, a pending batch would be lost */
+    if (rb->publishEvery || rb->pendLen) {
+        return RB_ERROR_INVALID;
+    }
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+
+    RB_MEMSET(bc, 0, sizeof(*bc));
+
+    rb->head = rb->tail;
+    rb->totalOut = rb->totalIn;
+
+    bc->rb = rb;
+    bc->baseOff = rb->tail;
+    bc->baseOut = rb->totalOut;
+    bc->lagLimit = lagLimit;
+    bc->writePos = 0;
+
+    return RB_OK;
+}
+
+int RingBufferBroadcastDelete(RingBufferBroadcast *bc)
+{
+    if (bc == nullptr || bc->rb == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    RB_MEMSET(bc, 0, sizeof(*bc));
+
+    return RB_OK;
+}
+
+uint32_t RingBufferBroadcastPut(RingBufferBroadcast *bc, uint8_t *data, uint32_t size)
+{
+    RingBufferBroadcastReader *r;
+    RingBuffer *rb;
+    uint64_t wp;
+    uint64_t min;
+    uint64_t pos;
+    uint32_t space;
+    uint32_t off;
+    uint32_t i;
+    int drop = 0;
+
+    if (bc == nullptr || bc->rb == nullptr || data == nullptr || size <= 0) {
+        return 0;
+    }
+    rb = bc->rb;
+
+    wp = bc->writePos;
+    min = wp;
+    for (i = 0; i < RINGBUFFER_BROADCAST_READERS; i++) {
+        r = &bc->reader[i];
+        if (r->active != BROADCAST_READER_ACTIVE || r->dropped) {
+            continue;
+        }
+        /* Resync stores pos before clearing dropped */
+        RB_MEMORY_BARRIER();
+        pos = r->pos;
+
+        if (bc->lagLimit && wp - pos > bc->lagLimit) {
+            r->dropped = 1;
+            r->droppedTimes++;
+            drop = 1;
+            continue;
+        }
+        if (pos < min) {
+            min = pos;
+        }
+    }
+    /* Dropped readers check the flag after reading, it must land before the data */
+    if (drop) {
+        RB_MEMORY_BARRIER();
+    }
+
+    space = rb->size - 1 - (uint32_t)(wp - min);
+    if (size > space) {
+        size = space;
+    }
+
+    if (size) {
+        off = _BroadcastOffset(bc, wp);
+        if (off + size <= rb->size) {
+            RB_MEMCPY(&rb->buff[off], &data[0], size);
+        } else {
+            RB_MEMCPY(&rb->buff[off], &data[0], rb->size - off);
+            RB_MEMCPY(&rb->buff[0], &data[rb->size - off], size - (rb->size - off));
+        }
+
+        RB_MEMORY_BARRIER();
+        bc->writePos = wp + size;
+    }
+
+    /* Mirror the backlog of the slowest reader into the ring */
+    rb->tail = _BroadcastOffset(bc, wp + size);
+    rb->totalIn += size;
+    rb->head = _BroadcastOffset(bc, min);
+    rb->totalOut = bc->baseOut + min;
+    rb->dataHasPut = 1;
+
+    return size;
+}
+
+int RingBufferBroadcastReaderAdd(RingBufferBroadcast *bc, uint32_t *id)
+{
+    RingBufferBroadcastReader *r;
+    uint32_t i;
+
+    if (bc == nullptr || bc->rb == nullptr || id == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    for (i = 0; i < RINGBUFFER_BROADCAST_READERS; i++) {
+        r = &bc->reader[i];
+        if (!RB_ATOMIC_CAS(&r->active, BROADCAST_READER_FREE, BROADCAST_READER_CLAIMED)) {
+            continue;
+        }
+
+        r->pos = bc->writePos;
+        r->dropped = 0;
+        r->maxLag = 0;
+        r->droppedTimes = 0;
+
+        RB_MEMORY_BARRIER();
+        r->active = BROADCAST_READER_ACTIVE;
+
+        *id = i;
+        return RB_OK;
+    }
+
+    return RB_ERROR_LOCKED;
+}
+
+int RingBufferBroadcastReaderRemove(RingBufferBroadcast *bc, uint32_t id)
+{
+    RingBufferBroadcastReader *r = _BroadcastReader(bc, id);
+
+    if (r == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    r->active = BROADCAST_READER_FREE;
+
+    return RB_OK;
+}
+
+int RingBufferBroadcastResync(RingBufferBroadcast *bc, uint32_t id)
+{
+    RingBufferBroadcastReader *r = _BroadcastReader(bc, id);
+
+    if (r == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    r->pos = bc->writePos;
+    RB_MEMORY_BARRIER();
+    r->dropped = 0;
+
+    return RB_OK;
+}
+
+uint32_t RingBufferBroadcastLenGet(RingBufferBroadcast *bc, uint32_t id)
+{
+    RingBufferBroadcastReader *r = _BroadcastReader(bc, id);
+
+    if (r == nullptr || r->dropped) {
+        return 0;
+    }
+
+    return (uint32_t)(bc->writePos - r->pos);
+}
+
+static uint32_t _BroadcastReadable(RingBufferBroadcast *bc, RingBufferBroadcastReader *r)
+{
+    uint64_t len = bc->writePos - r->pos;
+
+    /* Data behind writePos is complete */
+    RB_MEMORY_BARRIER();
+    if (len > r->maxLag) {
+        r->maxLag = len;
+    }
+
+    return (uint32_t)len;
+}
+
+uint32_t RingBufferBroadcastGet(RingBufferBroadcast *bc, uint32_t id, uint8_t *data, uint32_t size)
+{
+    RingBufferBroadcastReader *r = _BroadcastReader(bc, id);
+    RingBuffer *rb;
+    uint32_t len;
+    uint32_t off;
+
+    if (r == nullptr || r->dropped || data == nullptr || size <= 0) {
+        return 0;
+    }
+    rb = bc->rb;
+
+    len = _BroadcastReadable(bc, r);
+    if (size > len) {
+        size = len;
+    }
+    if (size == 0) {
+        return 0;
+    }
+
+    off = _BroadcastOffset(bc, r->pos);
+    if (off + size <= rb->size) {
+        RB_MEMCPY(&data[0], &rb->buff[off], size);
+    } else {
+        RB_MEMCPY(&data[0], &rb->buff[off], rb->size - off);
+        RB_MEMCPY(&data[rb->size - off], &rb->buff[0], size - (rb->size - off));
+    }
+
+    /* Pairs with the barrier after dropping in RingBufferBroadcastPut */
+    RB_MEMORY_BARRIER();
+    if (r->dropped) {
+        return 0;
+    }
+    r->pos += size;
+
+    return size;
+}
+
+uint32_t RingBufferBroadcastPeek(RingBufferBroadcast *bc, uint32_t id, const uint8_t **data)
+{
+    RingBufferBroadcastReader *r = _BroadcastReader(bc, id);
+    uint32_t len;
+    uint32_t off;
+
+    if (r == nullptr || r->dropped || data == nullptr) {
+        return 0;
+    }
+
+    len = _BroadcastReadable(bc, r);
+    off = _BroadcastOffset(bc, r->pos);
+    if (len > bc->rb->size - off) {
+        len = bc->rb->size - off;
+    }
+
+    *data = &bc->rb->buff[off];
+
+    return len;
+}
+
+int RingBufferBroadcastRelease(RingBufferBroadcast *bc, uint32_t id, uint32_t size)
+{
+    RingBufferBroadcastReader *r = _BroadcastReader(bc, id);
+
+    if (r == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+    if (size > bc->writePos - r->pos) {
+        return RB_ERROR_PARAM;
+    }
+
+    RB_MEMORY_BARRIER();
+    if (r->dropped) {
+        return RB_ERROR_INVALID;
+    }
+    r->pos += size;
+
+    return RB_OK;
+}
+
+int RingBufferBroadcastReaderStatGet(RingBufferBroadcast *bc, uint32_t id, RingBufferBroadcastReaderStat *stat)
+{
+    RingBufferBroadcastReader *r = _BroadcastReader(bc, id);
+
+    if (r == nullptr || stat == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    stat->totalOut = r->pos;
+    stat->lag = bc->writePos - r->pos;
+    stat->maxLag = r->maxLag;
+    stat->droppedTimes = r->droppedTimes;
+    stat->dropped = r->dropped;
+
+    return RB_OK;
+}
+
+#endif  /* RINGBUFFER_USE_BROADCAST */
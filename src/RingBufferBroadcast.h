@@ -0,0 +1,80 @@
+#ifndef __RINGBUFFER_BROADCAST_H__
+#define __RINGBUFFER_BROADCAST_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "RingBuffer.h"
+
+#if RINGBUFFER_USE_BROADCAST
+
+/*
+ * Broadcast mode: one producer, up to RINGBUFFER_BROADCAST_READERS
+ * readers, each with its own cursor over the same bytes of a cpu mode
+ * ring. A reader joins at the current write position.
+ *
+ * The producer is gated by the slowest reader, like RingBufferPut() by
+ * head. With a non-zero `lagLimit`, a reader lagging further behind is
+ * dropped instead: its reads fail until it calls
+ * RingBufferBroadcastResync(), which skips it forward to the write
+ * position. A reader dropped while it was reading in place gets
+ * RB_ERROR_INVALID from RingBufferBroadcastRelease() and must discard
+ * what it saw.
+ *
+ * rb->head/totalOut follow the slowest reader as of the last put, so the
+ * plain getters still report the backlog of the ring. Readers must not
+ * use RingBufferGet() on it.
+ */
+
+typedef struct {
+    RB_ALIGNED(RINGBUFFER_CACHE_LINE_SIZE) volatile uint64_t pos;   // Stream position, written by the reader
+    volatile uint32_t active;
+    volatile uint32_t dropped;          // Set by the producer
+    uint64_t maxLag;
+    uint64_t droppedTimes;
+} RingBufferBroadcastReader;
+
+typedef struct {
+    RingBuffer *rb;
+    uint32_t baseOff;                   // Ring offset of stream position 0
+    uint64_t baseOut;                   // rb->totalOut at stream position 0
+    uint32_t lagLimit;
+
+    RB_ALIGNED(RINGBUFFER_CACHE_LINE_SIZE) volatile uint64_t writePos;
+
+    RingBufferBroadcastReader reader[RINGBUFFER_BROADCAST_READERS];
+} RingBufferBroadcast;
+
+typedef struct {
+    uint64_t totalOut;
+    uint64_t lag;
+    uint64_t maxLag;
+    uint64_t droppedTimes;
+    uint32_t dropped;
+} RingBufferBroadcastReaderStat;
+
+/* Unread data in rb is discarded, lagLimit 0 gates the producer instead of dropping */
+int RingBufferBroadcastCreate(RingBufferBroadcast *bc, RingBuffer *rb, uint32_t lagLimit);
+int RingBufferBroadcastDelete(RingBufferBroadcast *bc);
+
+uint32_t RingBufferBroadcastPut(RingBufferBroadcast *bc, uint8_t *data, uint32_t size);
+
+int RingBufferBroadcastReaderAdd(RingBufferBroadcast *bc, uint32_t *id);
+int RingBufferBroadcastReaderRemove(RingBufferBroadcast *bc, uint32_t id);
+int RingBufferBroadcastResync(RingBufferBroadcast *bc, uint32_t id);
+
+uint32_t RingBufferBroadcastLenGet(RingBufferBroadcast *bc, uint32_t id);
+uint32_t RingBufferBroadcastGet(RingBufferBroadcast *bc, uint32_t id, uint8_t *data, uint32_t size);
+uint32_t RingBufferBroadcastPeek(RingBufferBroadcast *bc, uint32_t id, const uint8_t **data);  // Contiguous part
+int RingBufferBroadcastRelease(RingBufferBroadcast *bc, uint32_t id, uint32_t size);
+
+int RingBufferBroadcastReaderStatGet(RingBufferBroadcast *bc, uint32_t id, RingBufferBroadcastReaderStat *stat);
+
+#endif  /* RINGBUFFER_USE_BROADCAST */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__RINGBUFFER_BROADCAST_H__
@@ -0,0 +1,499 @@
+#include "RingBufferCompress.h"
+
+#if RINGBUFFER_USE_COMPRESS
+
+#include <errno.h>
+
+#if defined(_WIN32)
+#include <io.h>
+#define COMPRESS_READ(fd, buf, len)     _read(fd, buf, (unsigned int)(len))
+#define COMPRESS_WRITE(fd, buf, len)    _write(fd, buf, (unsigned int)(len))
+#else
+#include <unistd.h>
+#define COMPRESS_READ(fd, buf, len)     read(fd, buf, len)
+#define COMPRESS_WRITE(fd, buf, len)    write(fd, buf, len)
+#endif
+
+#ifndef nullptr
+#ifdef NULL
+#define nullptr NULL
+#else
+#define nullptr ((void *)0)
+#endif
+#endif
+
+#define LZ_MIN_MATCH                    4
+#define LZ_MAX_OFFSET                   65535
+#define LZ_LAST_LITERALS                5       // Matches stop this far from the end
+#define LZ_MF_LIMIT                     12      // No match starts in the last bytes
+
+static uint32_t _LZRead32(const uint8_t *p)
+{
+    uint32_t v;
+
+    RB_MEMCPY(&v, p, sizeof(v));
+    return v;
+}
+
+static uint32_t _LZHash(uint32_t v)
+{
+    return (v * 2654435761U) >> (32 - RINGBUFFER_LZ_HASH_BITS);
+}
+
+static uint8_t *_LZLengthPut(uint8_t *op, uint8_t *end, uint32_t len)
+{
+    while (len >= 255) {
+        if (op >= end) {
+            return nullptr;
+        }
+        *op++ = 255;
+        len -= 255;
+    }
+    if (op >= end) {
+        return nullptr;
+    }
+    *op++ = (uint8_t)len;
+
+    return op;
+}
+
+static uint8_t *_LZSequencePut(
+    uint8_t *op,
+    uint8_t *end,
+    const uint8_t *lit,
+    uint32_t litLen,
+    uint32_t offset,
+    uint32_t matchLen
+)
+{
+    uint8_t *token;
+    uint32_t ml = matchLen ? matchLen - LZ_MIN_MATCH : 0;
+
+    if (op >= end) {
+        return nullptr;
+    }
+    token = op++;
+    *token = (uint8_t)(((litLen < 15 ? litLen : 15) << 4) | (ml < 15 ? ml : 15));
+
+    if (litLen >= 15) {
+        op = _LZLengthPut(op, end, litLen - 15);
+        if (op == nullptr) {
+            return nullptr;
+        }
+    }
+    if ((uint32_t)(end - op) < litLen) {
+        return nullptr;
+    }
+    RB_MEMCPY(op, lit, litLen);
+    op += litLen;
+
+    if (matchLen == 0) {
+        return op;
+    }
+
+    if (end - op < 2) {
+        return nullptr;
+    }
+    *op++ = (uint8_t)offset;
+    *op++ = (uint8_t)(offset >> 8);
+    if (ml >= 15) {
+        op = _LZLengthPut(op, end, ml - 15);
+    }
+
+    return op;
+}
+
+uint32_t RingBufferLZCompress(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t cap, uint32_t *table)
+{
+    uint8_t *op = dst;
+    uint8_t *end = dst + cap;
+    uint32_t anchor = 0;
+    uint32_t ip = 0;
+    uint32_t ref;
+    uint32_t h;
+    uint32_t matchLen;
+
+    if (src == nullptr || dst == nullptr || table == nullptr) {
+        return 0;
+    }
+
+    /* Positions are stored plus one, zero is an empty slot */
+    RB_MEMSET(table, 0, RINGBUFFER_LZ_TABLE_SIZE * sizeof(uint32_t));
+
+    while (len > LZ_MF_LIMIT && ip < len - LZ_MF_LIMIT) {
+        h = _LZHash(_LZRead32(&src[ip]));
+        ref = table[h];
+        table[h] = ip + 1;
+
+        if (ref == 0 || ip - (ref - 1) > LZ_MAX_OFFSET || _LZRead32(&src[ref - 1]) != _LZRead32(&src[ip])) {
+            /* Step faster through data that does not match */
+            ip += 1 + ((ip - anchor) >> 6);
+            continue;
+        }
+        ref--;
+
+        matchLen = LZ_MIN_MATCH;
+        while (ip + matchLen < len - LZ_LAST_LITERALS && src[ref + matchLen] == src[ip + matchLen]) {
+            matchLen++;
+        }
+        while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) {
+            ip--;
+            ref--;
+            matchLen++;
+        }
+
+        op = _LZSequencePut(op, end, &src[anchor], ip - anchor, ip - ref, matchLen);
+        if (op == nullptr) {
+            return 0;
+        }
+
+        ip += matchLen;
+        anchor = ip;
+        if (ip - 2 < len - LZ_MF_LIMIT) {
+            table[_LZHash(_LZRead32(&src[ip - 2]))] = ip - 2 + 1;
+        }
+    }
+
+    op = _LZSequencePut(op, end, &src[anchor], len - anchor, 0, 0);
+    if (op == nullptr) {
+        return 0;
+    }
+
+    return (uint32_t)(op - dst);
+}
+
+static int _LZLengthGet(const uint8_t **ip, const uint8_t *end, uint32_t *len)
+{
+    uint8_t b;
+
+    do {
+        if (*ip >= end) {
+            return RB_ERROR_INVALID;
+        }
+        b = *(*ip)++;
+        if (*len > UINT32_MAX - b) {
+            return RB_ERROR_INVALID;
+        }
+        *len += b;
+    } while (b == 255);
+
+    return RB_OK;
+}
+
+int RingBufferLZDecompress(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t cap)
+{
+    const uint8_t *ip = src;
+    const uint8_t *end = src + len;
+    uint8_t *op = dst;
+    uint8_t *opEnd = dst + cap;
+    const uint8_t *match;
+    uint32_t litLen;
+    uint32_t matchLen;
+    uint32_t offset;
+    uint8_t token;
+
+    if (src == nullptr || dst == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    while (ip < end) {
+        token = *ip++;
+
+        litLen = token >> 4;
+        if (litLen == 15 && _LZLengthGet(&ip, end, &litLen)) {
+            return RB_ERROR_INVALID;
+        }
+        if ((uint32_t)(end - ip) < litLen || (uint32_t)(opEnd - op) < litLen) {
+            return RB_ERROR_INVALID;
+        }
+        RB_MEMCPY(op, ip, litLen);
+        ip += litLen;
+        op += litLen;
+
+        /* Last sequence carries literals only */
+        if (ip == end) {
+            break;
+        }
+
+        if (end - ip < 2) {
+            return RB_ERROR_INVALID;
+        }
+        offset = (uint32_t)ip[0] | ((uint32_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (uint32_t)(op - dst)) {
+            return RB_ERROR_INVALID;
+        }
+
+        matchLen = token & 0x0F;
+        if (matchLen == 15 && _LZLengthGet(&ip, end, &matchLen)) {
+            return RB_ERROR_INVALID;
+        }
+        matchLen += LZ_MIN_MATCH;
+        if ((uint32_t)(opEnd - op) < matchLen) {
+            return RB_ERROR_INVALID;
+        }
+
+        match = op - offset;
+        if (offset >= matchLen) {
+            RB_MEMCPY(op, match, matchLen);
+            op += matchLen;
+        } else {
+            /* Overlapping copy repeats the last `offset` bytes */
+            while (matchLen--) {
+                *op++ = *match++;
+            }
+        }
+    }
+
+    return (int)(op - dst);
+}
+
+static void _FrameLenPut(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t _FrameLenGet(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+int RingBufferCompressorCreate(RingBufferCompressor *c, RingBuffer *src, RingBuffer *det, int fd, uint32_t blockSize)
+{
+    if (c == nullptr || src == nullptr || blockSize <= 0) {
+        return RB_ERROR_PARAM;
+    }
+    if (det == nullptr && fd < 0) {
+        return RB_ERROR_PARAM;
+    }
+
+    RB_MEMSET(c, 0, sizeof(*c));
+    c->src = src;
+    c->det = det;
+    c->fd = fd;
+    c->blockSize = blockSize;
+
+    c->raw = (uint8_t *)RB_MALLOC(blockSize);
+    c->frame = (uint8_t *)RB_MALLOC(RINGBUFFER_FRAME_HEADER_SIZE + RINGBUFFER_LZ_BOUND(blockSize));
+    c->table = (uint32_t *)RB_MALLOC(RINGBUFFER_LZ_TABLE_SIZE * sizeof(uint32_t));
+    if (c->raw == nullptr || c->frame == nullptr || c->table == nullptr) {
+        RingBufferCompressorDelete(c);
+        return RB_ERROR_MEMORY;
+    }
+
+    return RB_OK;
+}
+
+int RingBufferCompressorDelete(RingBufferCompressor *c)
+{
+    if (c == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    if (c->raw) {
+        RB_FREE(c->raw);
+    }
+    if (c->frame) {
+        RB_FREE(c->frame);
+    }
+    if (c->table) {
+        RB_FREE(c->table);
+    }
+    RB_MEMSET(c, 0, sizeof(*c));
+    c->fd = -1;
+
+    return RB_OK;
+}
+
+/* Push the pending frame out, RB_ERROR_LOCKED while the output is full */
+static int _CompressorFlushFrame(RingBufferCompressor *c)
+{
+    uint32_t left;
+    long n;
+
+    while (c->frameOff < c->frameLen) {
+        left = c->frameLen - c->frameOff;
+        if (c->det) {
+            n = (long)RingBufferPut(c->det, &c->frame[c->frameOff], left);
+        } else {
+            n = (long)COMPRESS_WRITE(c->fd, &c->frame[c->frameOff], left);
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+                n = 0;
+            } else if (n < 0) {
+                return RB_ERROR_SYSTEM;
+            }
+        }
+        if (n == 0) {
+            return RB_ERROR_LOCKED;
+        }
+        c->frameOff += (uint32_t)n;
+    }
+
+    return RB_OK;
+}
+
+int RingBufferCompressorRun(RingBufferCompressor *c, int flush)
+{
+    uint32_t len;
+    uint32_t comp;
+    int status;
+
+    if (c == nullptr || c->raw == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    while (1) {
+        status = _CompressorFlushFrame(c);
+        if (status == RB_ERROR_LOCKED) {
+            return RB_OK;
+        } else if (status) {
+            return status;
+        }
+
+        len = RingBufferLenGet(c->src);
+        if (len == 0 || (len < c->blockSize && !flush)) {
+            return RB_OK;
+        }
+
+        len = RingBufferGet(c->src, c->raw, c->blockSize);
+        comp = RingBufferLZCompress(c->raw, len, &c->frame[RINGBUFFER_FRAME_HEADER_SIZE],
+                                    RINGBUFFER_LZ_BOUND(c->blockSize), c->table);
+        if (comp == 0 || comp >= len) {
+            RB_MEMCPY(&c->frame[RINGBUFFER_FRAME_HEADER_SIZE], c->raw, len);
+            comp = len;
+        }
+        _FrameLenPut(&c->frame[0], len);
+        _FrameLenPut(&c->frame[4], comp);
+
+        c->frameOff = 0;
+        c->frameLen = RINGBUFFER_FRAME_HEADER_SIZE + comp;
+        c->rawBytes += len;
+        c->compBytes += c->frameLen;
+    }
+}
+
+int RingBufferDecompressorCreate(RingBufferDecompressor *d, RingBuffer *src, int fd, RingBuffer *det, uint32_t blockSize)
+{
+    if (d == nullptr || det == nullptr || blockSize <= 0) {
+        return RB_ERROR_PARAM;
+    }
+    if (src == nullptr && fd < 0) {
+        return RB_ERROR_PARAM;
+    }
+
+    RB_MEMSET(d, 0, sizeof(*d));
+    d->src = src;
+    d->fd = fd;
+    d->det = det;
+    d->blockSize = blockSize;
+
+    d->frame = (uint8_t *)RB_MALLOC(RINGBUFFER_FRAME_HEADER_SIZE + RINGBUFFER_LZ_BOUND(blockSize));
+    d->raw = (uint8_t *)RB_MALLOC(blockSize);
+    if (d->frame == nullptr || d->raw == nullptr) {
+        RingBufferDecompressorDelete(d);
+        return RB_ERROR_MEMORY;
+    }
+
+    return RB_OK;
+}
+
+int RingBufferDecompressorDelete(RingBufferDecompressor *d)
+{
+    if (d == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    if (d->frame) {
+        RB_FREE(d->frame);
+    }
+    if (d->raw) {
+        RB_FREE(d->raw);
+    }
+    RB_MEMSET(d, 0, sizeof(*d));
+    d->fd = -1;
+
+    return RB_OK;
+}
+
+/* Gather the frame up to `need` bytes, RB_ERROR_LOCKED until they are all in */
+static int _DecompressorFill(RingBufferDecompressor *d, uint32_t need)
+{
+    long n;
+
+    while (d->frameLen < need) {
+        if (d->src) {
+            n = (long)RingBufferGet(d->src, &d->frame[d->frameLen], need - d->frameLen);
+        } else {
+            n = (long)COMPRESS_READ(d->fd, &d->frame[d->frameLen], need - d->frameLen);
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+                n = 0;
+            } else if (n < 0) {
+                return RB_ERROR_SYSTEM;
+            }
+        }
+        if (n == 0) {
+            return RB_ERROR_LOCKED;
+        }
+        d->frameLen += (uint32_t)n;
+    }
+
+    return RB_OK;
+}
+
+int RingBufferDecompressorRun(RingBufferDecompressor *d)
+{
+    uint32_t rawLen;
+    uint32_t compLen;
+    int status;
+    int n;
+
+    if (d == nullptr || d->frame == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    while (1) {
+        while (d->rawOff < d->rawLen) {
+            n = (int)RingBufferPut(d->det, &d->raw[d->rawOff], d->rawLen - d->rawOff);
+            if (n == 0) {
+                return RB_OK;
+            }
+            d->rawOff += (uint32_t)n;
+        }
+
+        status = _DecompressorFill(d, RINGBUFFER_FRAME_HEADER_SIZE);
+        if (status) {
+            return status == RB_ERROR_LOCKED ? RB_OK : status;
+        }
+
+        rawLen = _FrameLenGet(&d->frame[0]);
+        compLen = _FrameLenGet(&d->frame[4]);
+        if (rawLen == 0 || rawLen > d->blockSize || compLen == 0 || compLen > RINGBUFFER_LZ_BOUND(d->blockSize)) {
+            return RB_ERROR_INVALID;
+        }
+
+        status = _DecompressorFill(d, RINGBUFFER_FRAME_HEADER_SIZE + compLen);
+        if (status) {
+            return status == RB_ERROR_LOCKED ? RB_OK : status;
+        }
+
+        if (compLen == rawLen) {
+            RB_MEMCPY(d->raw, &d->frame[RINGBUFFER_FRAME_HEADER_SIZE], rawLen);
+        } else {
+            n = RingBufferLZDecompress(&d->frame[RINGBUFFER_FRAME_HEADER_SIZE], compLen, d->raw, d->blockSize);
+            if (n != (int)rawLen) {
+                return RB_ERROR_INVALID;
+            }
+        }
+
+        d->frameLen = 0;
+        d->rawOff = 0;
+        d->rawLen = rawLen;
+        d->rawBytes += rawLen;
+        d->compBytes += RINGBUFFER_FRAME_HEADER_SIZE + compLen;
+    }
+}
+
+#endif  /* RINGBUFFER_USE_COMPRESS */
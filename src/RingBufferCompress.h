@@ -0,0 +1,96 @@
+#ifndef __RINGBUFFER_COMPRESS_H__
+#define __RINGBUFFER_COMPRESS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "RingBuffer.h"
+
+#if RINGBUFFER_USE_COMPRESS
+
+/*
+ * Fast LZ77 block codec, LZ4-like sequences of
+ *   token | literal length ext | literals | offset (2 bytes LE) | match length ext
+ * with 4 bit literal/match lengths in the token extended by 255 bytes,
+ * minimum match 4 and a 64KiB window. The last sequence has no match.
+ */
+
+#define RINGBUFFER_LZ_HASH_BITS         12
+#define RINGBUFFER_LZ_TABLE_SIZE        (1U << RINGBUFFER_LZ_HASH_BITS)     // Entries of the work table
+#define RINGBUFFER_LZ_BOUND(n)          ((n) + (n) / 255 + 16)              // Worst case output size
+
+/* Returns the compressed size, 0 if it does not fit in cap */
+uint32_t RingBufferLZCompress(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t cap, uint32_t *table);
+/* Returns the decompressed size, RB_ERROR_INVALID on malformed input */
+int RingBufferLZDecompress(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t cap);
+
+/*
+ * Compression stage: takes the readable data of `src` in blocks of up to
+ * `blockSize` bytes and emits frames
+ *   raw length (4 bytes LE) | payload length (4 bytes LE) | payload
+ * into the ring `det`, or the file descriptor `fd` when det is nullptr.
+ * The payload is stored raw when it would not shrink (lengths equal).
+ *
+ * RingBufferCompressorRun() waits for full blocks unless `flush` is set,
+ * and returns when the output is full; the frame in progress is kept and
+ * resumed by the next call.
+ */
+
+#define RINGBUFFER_FRAME_HEADER_SIZE    8
+
+typedef struct {
+    RingBuffer *src;
+    RingBuffer *det;
+    int fd;
+
+    uint32_t blockSize;
+    uint8_t *raw;
+    uint8_t *frame;
+    uint32_t *table;
+
+    uint32_t frameOff;                  // Part of the frame already written out
+    uint32_t frameLen;
+
+    uint64_t rawBytes;
+    uint64_t compBytes;                 // Frames including headers
+} RingBufferCompressor;
+
+int RingBufferCompressorCreate(RingBufferCompressor *c, RingBuffer *src, RingBuffer *det, int fd, uint32_t blockSize);
+int RingBufferCompressorDelete(RingBufferCompressor *c);
+int RingBufferCompressorRun(RingBufferCompressor *c, int flush);
+
+/*
+ * Decompression stage: reads frames from the ring `src`, or `fd` when src
+ * is nullptr, and puts the data into `det`. blockSize must be at least the
+ * compressor's. A partial frame is kept until the rest arrives.
+ */
+
+typedef struct {
+    RingBuffer *src;
+    int fd;
+    RingBuffer *det;
+
+    uint32_t blockSize;
+    uint8_t *frame;
+    uint8_t *raw;
+
+    uint32_t frameLen;                  // Bytes of the current frame received
+    uint32_t rawOff;                    // Part of the block already put into det
+    uint32_t rawLen;
+
+    uint64_t rawBytes;
+    uint64_t compBytes;
+} RingBufferDecompressor;
+
+int RingBufferDecompressorCreate(RingBufferDecompressor *d, RingBuffer *src, int fd, RingBuffer *det, uint32_t blockSize);
+int RingBufferDecompressorDelete(RingBufferDecompressor *d);
+int RingBufferDecompressorRun(RingBufferDecompressor *d);  // RB_ERROR_INVALID on a corrupt stream
+
+#endif  /* RINGBUFFER_USE_COMPRESS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__RINGBUFFER_COMPRESS_H__
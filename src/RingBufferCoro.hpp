@@ -0,0 +1,312 @@
+#ifndef __RINGBUFFER_CORO_HPP__
+#define __RINGBUFFER_CORO_HPP__
+
+#include "RingBuffer.h"
+
+#if defined(__cplusplus) && __cplusplus >= 202002L && __has_include(<coroutine>)
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+
+/*
+ * C++20 coroutine front end for a cpu mode ring, header only.
+ *
+ *     RingBufferTask Producer(RingBufferAsync &ring) {
+ *         uint32_t len = co_await ring.Write(data, size);     // >= 1 byte
+ *     }
+ *
+ * Read and Write complete with at least one byte, like read(2)/write(2),
+ * and suspend while the ring is empty or full. The Read or Write on the
+ * other side posts the sleeping coroutine back to the executor it was
+ * spawned on. The ring stays single producer / single consumer: at most
+ * one coroutine reads and one writes at a time, the two may run on
+ * executors of different threads.
+ *
+ * RingBufferExecutor is a plain ready queue drained by the thread calling
+ * Run(); one executor per thread drives any number of coroutines.
+ */
+
+class RingBufferExecutor;
+
+class RingBufferTask {
+public:
+    struct promise_type {
+        RingBufferExecutor *executor = nullptr;
+
+        RingBufferTask get_return_object()
+        {
+            return RingBufferTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+        ~promise_type();
+    };
+
+    RingBufferTask(RingBufferTask &&other) noexcept : handle_(other.handle_) { other.handle_ = nullptr; }
+    RingBufferTask(const RingBufferTask &) = delete;
+    RingBufferTask &operator=(const RingBufferTask &) = delete;
+    ~RingBufferTask()
+    {
+        /* Never spawned */
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+private:
+    friend class RingBufferExecutor;
+
+    explicit RingBufferTask(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+class RingBufferExecutor {
+public:
+    /* Takes the task over, it first runs inside Run() */
+    void Spawn(RingBufferTask task)
+    {
+        std::coroutine_handle<RingBufferTask::promise_type> handle = task.handle_;
+
+        task.handle_ = nullptr;
+        handle.promise().executor = this;
+        live_.fetch_add(1, std::memory_order_relaxed);
+        Post(handle);
+    }
+
+    /* Safe from any thread */
+    void Post(std::coroutine_handle<> handle)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready_.push_back(handle);
+        }
+        cond_.notify_one();
+    }
+
+    /* Returns once every spawned task has finished, or when Stop() finds nothing ready */
+    void Run()
+    {
+        std::coroutine_handle<> handle;
+
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cond_.wait(lock, [this] {
+                    return !ready_.empty() || stop_ || live_.load(std::memory_order_acquire) == 0;
+                });
+                if (ready_.empty()) {
+                    stop_ = false;
+                    return;
+                }
+                handle = ready_.front();
+                ready_.pop_front();
+            }
+            handle.resume();
+        }
+    }
+
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cond_.notify_all();
+    }
+
+private:
+    friend struct RingBufferTask::promise_type;
+
+    void TaskDone()
+    {
+        if (live_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cond_.notify_all();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<std::coroutine_handle<>> ready_;
+    std::atomic<uint32_t> live_{0};
+    bool stop_ = false;
+};
+
+inline RingBufferTask::promise_type::~promise_type()
+{
+    if (executor) {
+        executor->TaskDone();
+    }
+}
+
+class RingBufferAsync {
+private:
+    struct Waiter {
+        std::coroutine_handle<> handle;
+        RingBufferExecutor *executor;
+    };
+
+public:
+    /* `executor` resumes coroutines of this ring that were not spawned on one */
+    RingBufferAsync(RingBuffer *rb, RingBufferExecutor &executor) : rb_(rb), executor_(&executor) {}
+    RingBufferAsync(const RingBufferAsync &) = delete;
+    RingBufferAsync &operator=(const RingBufferAsync &) = delete;
+
+    RingBuffer *Ring() const { return rb_; }
+
+    class ReadAwaiter {
+    public:
+        ReadAwaiter(RingBufferAsync &ring, uint8_t *data, uint32_t size) : ring_(ring), data_(data), size_(size) {}
+
+        bool await_ready()
+        {
+            return size_ == 0 || TryGet();
+        }
+
+        template <typename Promise>
+        bool await_suspend(std::coroutine_handle<Promise> handle)
+        {
+            return ring_.Park(ring_.reader_, waiter_, handle, [this] { return RingBufferLenGet(ring_.rb_) != 0; });
+        }
+
+        uint32_t await_resume()
+        {
+            if (len_ == 0 && size_ != 0) {
+                TryGet();
+            }
+            return len_;
+        }
+
+    private:
+        bool TryGet()
+        {
+            len_ = RingBufferGet(ring_.rb_, data_, size_);
+            if (len_) {
+                ring_.Wake(ring_.writer_, [this] { return RingBufferSpaceGet(ring_.rb_) != 0; });
+            }
+            return len_ != 0;
+        }
+
+        RingBufferAsync &ring_;
+        uint8_t *data_;
+        uint32_t size_;
+        uint32_t len_ = 0;
+        Waiter waiter_;
+    };
+
+    class WriteAwaiter {
+    public:
+        WriteAwaiter(RingBufferAsync &ring, uint8_t *data, uint32_t size) : ring_(ring), data_(data), size_(size) {}
+
+        bool await_ready()
+        {
+            return size_ == 0 || TryPut();
+        }
+
+        template <typename Promise>
+        bool await_suspend(std::coroutine_handle<Promise> handle)
+        {
+            return ring_.Park(ring_.writer_, waiter_, handle, [this] {
+                return RingBufferSpaceGet(ring_.rb_) != 0;
+            });
+        }
+
+        uint32_t await_resume()
+        {
+            if (len_ == 0 && size_ != 0) {
+                TryPut();
+            }
+            return len_;
+        }
+
+    private:
+        bool TryPut()
+        {
+            len_ = RingBufferPut(ring_.rb_, data_, size_);
+            if (len_) {
+                ring_.Wake(ring_.reader_, [this] { return RingBufferLenGet(ring_.rb_) != 0; });
+            }
+            return len_ != 0;
+        }
+
+        RingBufferAsync &ring_;
+        uint8_t *data_;
+        uint32_t size_;
+        uint32_t len_ = 0;
+        Waiter waiter_;
+    };
+
+    ReadAwaiter Read(uint8_t *data, uint32_t size) { return ReadAwaiter(*this, data, size); }
+    WriteAwaiter Write(uint8_t *data, uint32_t size) { return WriteAwaiter(*this, data, size); }
+
+private:
+    template <typename Promise>
+    RingBufferExecutor *ExecutorOf(std::coroutine_handle<Promise> handle)
+    {
+        if constexpr (requires { handle.promise().executor; }) {
+            if (handle.promise().executor) {
+                return handle.promise().executor;
+            }
+        }
+        return executor_;
+    }
+
+    /* Publish the waiter, then look again so a concurrent Wake is never missed */
+    template <typename Promise, typename Ready>
+    bool Park(std::atomic<Waiter *> &slot, Waiter &waiter, std::coroutine_handle<Promise> handle, Ready ready)
+    {
+        Waiter *self = &waiter;
+
+        waiter.handle = handle;
+        waiter.executor = ExecutorOf(handle);
+        slot.store(self, std::memory_order_seq_cst);
+
+        if (!ready()) {
+            return true;
+        }
+        /* Lost the race to Wake: it already posted us */
+        return !slot.compare_exchange_strong(self, nullptr, std::memory_order_seq_cst);
+    }
+
+    /*
+     * `ready` is the condition the waiter parked on. The waiter may have
+     * parked again after taking what we made ready: it goes back to the
+     * slot then, only our side can make its condition true.
+     */
+    template <typename Ready>
+    void Wake(std::atomic<Waiter *> &slot, Ready ready)
+    {
+        Waiter *waiter;
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (slot.load(std::memory_order_relaxed) == nullptr) {
+            return;
+        }
+        waiter = slot.exchange(nullptr, std::memory_order_acq_rel);
+        if (waiter == nullptr) {
+            return;
+        }
+        if (!ready()) {
+            slot.store(waiter, std::memory_order_seq_cst);
+            return;
+        }
+        waiter->executor->Post(waiter->handle);
+    }
+
+    RingBuffer *rb_;
+    RingBufferExecutor *executor_;
+    std::atomic<Waiter *> reader_{nullptr};
+    std::atomic<Waiter *> writer_{nullptr};
+};
+
+#endif  /* __cplusplus >= 202002L */
+
+#endif  // !__RINGBUFFER_CORO_HPP__
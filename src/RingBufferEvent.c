@@ -0,0 +1,203 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "RingBufferEvent.h"
+
+#if RINGBUFFER_USE_EVENTFD && defined(__linux__)
+
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#ifndef nullptr
+#ifdef NULL
+#define nullptr NULL
+#else
+#define nullptr ((void *)0)
+#endif
+#endif
+
+static uint32_t _EventSpace(RingBuffer *rb)
+{
+    return RingBufferSpaceGet(rb);
+}
+
+/* A ring never holds more than size - 1 bytes, a bigger want would never fire */
+static uint32_t _EventWant(RingBuffer *rb, uint32_t size)
+{
+    if (size == 0) {
+        return 1;
+    }
+
+    return size < rb->size - 1 ? size : rb->size - 1;
+}
+
+static void _EventDrain(int fd)
+{
+    eventfd_t value;
+
+    eventfd_read(fd, &value);
+}
+
+/* Only the side that disarms writes, one wakeup per arm */
+static int _EventFire(int fd, volatile uint32_t *armed)
+{
+    if (!RB_ATOMIC_CAS(armed, 1U, 0U)) {
+        return 0;
+    }
+    eventfd_write(fd, 1);
+
+    return 1;
+}
+
+int RingBufferEventCreate(RingBufferEvent *ev, RingBuffer *rb)
+{
+    if (ev == nullptr || rb == nullptr || rb->buff == nullptr || rb->size <= 1) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->mode != RINGBUFFER_CPU_MODE) {
+        return RB_ERROR_INVALID;
+    }
+
+    RB_MEMSET(ev, 0, sizeof(*ev));
+    ev->rb = rb;
+
+    ev->dataFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (ev->dataFd < 0) {
+        return RB_ERROR_SYSTEM;
+    }
+    ev->spaceFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (ev->spaceFd < 0) {
+        close(ev->dataFd);
+        ev->dataFd = -1;
+        return RB_ERROR_SYSTEM;
+    }
+
+    return RB_OK;
+}
+
+int RingBufferEventDelete(RingBufferEvent *ev)
+{
+    if (ev == nullptr || ev->rb == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    close(ev->dataFd);
+    close(ev->spaceFd);
+
+    RB_MEMSET(ev, 0, sizeof(*ev));
+    ev->dataFd = -1;
+    ev->spaceFd = -1;
+
+    return RB_OK;
+}
+
+int RingBufferEventDataFdGet(RingBufferEvent *ev)
+{
+    if (ev == nullptr || ev->rb == nullptr) {
+        return -1;
+    }
+
+    return ev->dataFd;
+}
+
+int RingBufferEventSpaceFdGet(RingBufferEvent *ev)
+{
+    if (ev == nullptr || ev->rb == nullptr) {
+        return -1;
+    }
+
+    return ev->spaceFd;
+}
+
+uint32_t RingBufferEventPut(RingBufferEvent *ev, uint8_t *data, uint32_t size)
+{
+    uint32_t len;
+
+    if (ev == nullptr || ev->rb == nullptr) {
+        return 0;
+    }
+
+    len = RingBufferPut(ev->rb, data, size);
+
+    /* The tail store is visible before the armed flag is read */
+    RB_MEMORY_BARRIER();
+    if (len && ev->dataArmed && RingBufferLenGet(ev->rb) >= ev->dataWant) {
+        ev->dataSignals += _EventFire(ev->dataFd, &ev->dataArmed);
+    }
+
+    return len;
+}
+
+uint32_t RingBufferEventGet(RingBufferEvent *ev, uint8_t *data, uint32_t size)
+{
+    uint32_t len;
+
+    if (ev == nullptr || ev->rb == nullptr) {
+        return 0;
+    }
+
+    len = RingBufferGet(ev->rb, data, size);
+
+    RB_MEMORY_BARRIER();
+    if (len && ev->spaceArmed && _EventSpace(ev->rb) >= ev->spaceWant) {
+        ev->spaceSignals += _EventFire(ev->spaceFd, &ev->spaceArmed);
+    }
+
+    return len;
+}
+
+uint32_t RingBufferEventDataArm(RingBufferEvent *ev, uint32_t size)
+{
+    uint32_t len;
+
+    if (ev == nullptr || ev->rb == nullptr) {
+        return 0;
+    }
+
+    _EventDrain(ev->dataFd);
+    ev->dataWant = _EventWant(ev->rb, size);
+    ev->dataArmed = 1;
+
+    /* Pairs with the barrier in RingBufferEventPut(), one of both sees the other */
+    RB_MEMORY_BARRIER();
+    len = RingBufferLenGet(ev->rb);
+    if (len >= ev->dataWant) {
+        /* If the producer already fired, the stale wakeup is drained next time */
+        RB_ATOMIC_CAS(&ev->dataArmed, 1U, 0U);
+        return len;
+    }
+
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+    /* Like a get that missed: a batching producer publishes its next put at once */
+    if (ev->rb->publishEvery && !ev->rb->consumerWaiting) {
+        ev->rb->consumerWaiting = 1;
+    }
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+
+    return 0;
+}
+
+uint32_t RingBufferEventSpaceArm(RingBufferEvent *ev, uint32_t size)
+{
+    uint32_t space;
+
+    if (ev == nullptr || ev->rb == nullptr) {
+        return 0;
+    }
+
+    _EventDrain(ev->spaceFd);
+    ev->spaceWant = _EventWant(ev->rb, size);
+    ev->spaceArmed = 1;
+
+    RB_MEMORY_BARRIER();
+    space = _EventSpace(ev->rb);
+    if (space >= ev->spaceWant) {
+        RB_ATOMIC_CAS(&ev->spaceArmed, 1U, 0U);
+        return space;
+    }
+
+    return 0;
+}
+
+#endif  /* RINGBUFFER_USE_EVENTFD && __linux__ */
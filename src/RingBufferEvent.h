@@ -0,0 +1,60 @@
+#ifndef __RINGBUFFER_EVENT_H__
+#define __RINGBUFFER_EVENT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "RingBuffer.h"
+
+#if RINGBUFFER_USE_EVENTFD && defined(__linux__)
+
+/*
+ * eventfd wakeups for a cpu mode ring, so either side can sit in an
+ * epoll/poll loop next to sockets instead of polling RingBufferLenGet().
+ *
+ * A side that runs dry arms its eventfd with RingBufferEventDataArm() or
+ * RingBufferEventSpaceArm(). They return what is available right now; only
+ * when that is 0 the side is armed and should wait for EPOLLIN on the fd.
+ * The other side writes the eventfd once, on the Put or Get that makes
+ * enough data or space available, and stays silent while nobody is armed.
+ * Both fds are non-blocking and drained by the next Arm call.
+ */
+
+typedef struct {
+    RingBuffer *rb;
+    int dataFd;
+    int spaceFd;
+
+    /* Armed by the consumer, fired by the producer */
+    RB_ALIGNED(RINGBUFFER_CACHE_LINE_SIZE) volatile uint32_t dataArmed;
+    uint32_t dataWant;
+    uint64_t dataSignals;
+
+    /* Armed by the producer, fired by the consumer */
+    RB_ALIGNED(RINGBUFFER_CACHE_LINE_SIZE) volatile uint32_t spaceArmed;
+    uint32_t spaceWant;
+    uint64_t spaceSignals;
+} RingBufferEvent;
+
+int RingBufferEventCreate(RingBufferEvent *ev, RingBuffer *rb);
+int RingBufferEventDelete(RingBufferEvent *ev);
+
+int RingBufferEventDataFdGet(RingBufferEvent *ev);
+int RingBufferEventSpaceFdGet(RingBufferEvent *ev);
+
+uint32_t RingBufferEventPut(RingBufferEvent *ev, uint8_t *data, uint32_t size);
+uint32_t RingBufferEventGet(RingBufferEvent *ev, uint8_t *data, uint32_t size);
+
+/* Returns the readable length, 0 means armed until at least `size` bytes are in (0 for 1, capped at size - 1) */
+uint32_t RingBufferEventDataArm(RingBufferEvent *ev, uint32_t size);
+/* Returns the free space, 0 means armed until at least `size` bytes are free (0 for 1, capped at size - 1) */
+uint32_t RingBufferEventSpaceArm(RingBufferEvent *ev, uint32_t size);
+
+#endif  /* RINGBUFFER_USE_EVENTFD && __linux__ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__RINGBUFFER_EVENT_H__
@@ -0,0 +1,181 @@
+#ifndef __RINGBUFFER_FAST_H__
+#define __RINGBUFFER_FAST_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "RingBuffer.h"
+
+/*
+ * Inline fast path for cpu mode rings, for byte- and word-sized transfers
+ * where the checks of RingBufferPut()/RingBufferGet() cost more than the
+ * copy.
+ *
+ * Nothing is validated: the ring must come from a successful Init or
+ * Create, stay in cpu mode, and have deferred publish off, with one
+ * producer and one consumer as usual. RINGBUFFER_FAST_CHECK turns these
+ * conditions into asserts. Statistics, trace probes and dataHasPut are not
+ * updated; it mixes freely with the checked calls otherwise.
+ */
+
+#if RINGBUFFER_FAST_CHECK
+#include <assert.h>
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+#define RB_FAST_ASSERT(rb)                                                        \
+    assert((rb) && (rb)->buff && (rb)->size > 1 &&                                \
+           (rb)->mode == RINGBUFFER_CPU_MODE && (rb)->publishEvery == 0)
+#else
+#define RB_FAST_ASSERT(rb)                                                        \
+    assert((rb) && (rb)->buff && (rb)->size > 1 &&                                \
+           (rb)->mode == RINGBUFFER_CPU_MODE)
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+#else
+#define RB_FAST_ASSERT(rb)              ((void)0)
+#endif  /* RINGBUFFER_FAST_CHECK */
+
+static inline uint32_t _RingBufferFastLen(uint32_t head, uint32_t tail, uint32_t size)
+{
+    return tail >= head ? tail - head : size - head + tail;
+}
+
+static inline uint32_t RingBufferFastLenGet(RingBuffer *rb)
+{
+    RB_FAST_ASSERT(rb);
+    return _RingBufferFastLen(rb->head, rb->tail, rb->size);
+}
+
+static inline uint32_t RingBufferFastPut(RingBuffer *rb, const uint8_t *data, uint32_t size)
+{
+    uint32_t tail;
+    uint32_t space;
+    uint32_t first;
+
+    RB_FAST_ASSERT(rb);
+    tail = rb->tail;
+
+    space = rb->size - 1 - _RingBufferFastLen(rb->head, tail, rb->size);
+    if (size > space) {
+        size = space;
+    }
+
+    first = rb->size - tail;
+    if (size <= first) {
+        RB_MEMCPY(&rb->buff[tail], data, size);
+        tail += size;
+        if (tail == rb->size) {
+            tail = 0;
+        }
+    } else {
+        RB_MEMCPY(&rb->buff[tail], data, first);
+        RB_MEMCPY(&rb->buff[0], &data[first], size - first);
+        tail = size - first;
+    }
+
+    RB_PUBLISH_BARRIER();
+    rb->tail = tail;
+    rb->totalIn += size;
+
+    return size;
+}
+
+static inline uint32_t RingBufferFastGet(RingBuffer *rb, uint8_t *data, uint32_t size)
+{
+    uint32_t head;
+    uint32_t len;
+    uint32_t first;
+
+    RB_FAST_ASSERT(rb);
+    head = rb->head;
+
+    len = _RingBufferFastLen(head, rb->tail, rb->size);
+    RB_PUBLISH_BARRIER();
+    if (size > len) {
+        size = len;
+    }
+
+    first = rb->size - head;
+    if (size <= first) {
+        RB_MEMCPY(data, &rb->buff[head], size);
+        head += size;
+        if (head == rb->size) {
+            head = 0;
+        }
+    } else {
+        RB_MEMCPY(data, &rb->buff[head], first);
+        RB_MEMCPY(&data[first], &rb->buff[0], size - first);
+        head = size - first;
+    }
+
+    RB_PUBLISH_BARRIER();
+    rb->head = head;
+    rb->totalOut += size;
+
+    return size;
+}
+
+/* 1 when the byte went in, 0 when the ring is full */
+static inline int RingBufferFastPush(RingBuffer *rb, uint8_t byte)
+{
+    uint32_t tail;
+    uint32_t next;
+
+    RB_FAST_ASSERT(rb);
+    tail = rb->tail;
+    next = tail + 1 == rb->size ? 0 : tail + 1;
+
+    if (next == rb->head) {
+        return 0;
+    }
+    rb->buff[tail] = byte;
+
+    RB_PUBLISH_BARRIER();
+    rb->tail = next;
+    rb->totalIn++;
+
+    return 1;
+}
+
+/* 1 when a byte came out, 0 when the ring is empty */
+static inline int RingBufferFastPop(RingBuffer *rb, uint8_t *byte)
+{
+    uint32_t head;
+
+    RB_FAST_ASSERT(rb);
+    head = rb->head;
+
+    if (head == rb->tail) {
+        return 0;
+    }
+    RB_PUBLISH_BARRIER();
+    *byte = rb->buff[head];
+
+    RB_PUBLISH_BARRIER();
+    rb->head = head + 1 == rb->size ? 0 : head + 1;
+    rb->totalOut++;
+
+    return 1;
+}
+
+/* Like RingBufferFastPop() without consuming the byte */
+static inline int RingBufferFastPeek(RingBuffer *rb, uint8_t *byte)
+{
+    uint32_t head;
+
+    RB_FAST_ASSERT(rb);
+    head = rb->head;
+
+    if (head == rb->tail) {
+        return 0;
+    }
+    RB_PUBLISH_BARRIER();
+    *byte = rb->buff[head];
+
+    return 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__RINGBUFFER_FAST_H__
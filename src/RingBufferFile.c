@@ -0,0 +1,376 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "RingBufferFile.h"
+
+#if RINGBUFFER_USE_FILE && defined(__linux__)
+
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifndef nullptr
+#ifdef NULL
+#define nullptr NULL
+#else
+#define nullptr ((void *)0)
+#endif
+#endif
+
+#define FILE_MAGIC                      0x52424649U     // "RBFI"
+#define FILE_VERSION                    1U
+
+static uint64_t _FileNowMs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+/* FNV-1a over the checkpoint without its checksum field */
+static uint32_t _FileChecksum(const RingBufferFileCheckpoint *cp)
+{
+    const uint8_t *p = (const uint8_t *)cp;
+    uint32_t sum = 2166136261U;
+    uint32_t i;
+
+    for (i = 0; i < (uint32_t)((const uint8_t *)&cp->checksum - p); i++) {
+        sum = (sum ^ p[i]) * 16777619U;
+    }
+
+    return sum;
+}
+
+static int _FileIndexValid(uint32_t size, uint32_t head, uint32_t tail, uint64_t totalIn, uint64_t totalOut)
+{
+    if (head >= size || tail >= size || totalOut > totalIn) {
+        return 0;
+    }
+    if (totalIn - totalOut >= size) {
+        return 0;
+    }
+
+    return (tail + size - head) % size == totalIn - totalOut;
+}
+
+static void _FileMsync(RingBufferFile *rbf, uint64_t offset, uint64_t len)
+{
+    uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+    uint64_t start = offset & ~(page - 1);
+    uint64_t end = offset + len;
+
+    if (len == 0) {
+        return;
+    }
+
+    msync((uint8_t *)rbf->hdr + start, (size_t)(end - start), MS_SYNC);
+}
+
+static void _FileCheckpointWrite(RingBufferFile *rbf, uint32_t tail, uint64_t totalIn)
+{
+    RingBufferFileCheckpoint cp;
+    int retry;
+
+    cp.tail = tail;
+    cp.totalIn = totalIn;
+    cp.seq = rbf->hdr->checkpoint.seq + 1;
+    cp.reserved = 0;
+
+    /* head and totalOut are read while the consumer may move them */
+    for (retry = 0; retry < 4; retry++) {
+        cp.head = rbf->rb.head;
+        cp.totalOut = rbf->rb.totalOut;
+        if (_FileIndexValid(rbf->rb.size, cp.head, cp.tail, cp.totalIn, cp.totalOut)) {
+            break;
+        }
+    }
+    if (retry == 4) {
+        return;
+    }
+    cp.checksum = _FileChecksum(&cp);
+
+    rbf->hdr->checkpoint = cp;
+    _FileMsync(rbf, 0, sizeof(RingBufferFileHeader));
+}
+
+static void _FileLiveUpdate(RingBufferFile *rbf)
+{
+    RingBufferFileHeader *hdr = rbf->hdr;
+
+    hdr->head = rbf->rb.head;
+    hdr->tail = rbf->rb.tail;
+    hdr->totalIn = rbf->rb.totalIn;
+    hdr->totalOut = rbf->rb.totalOut;
+}
+
+/*
+ * Free space as a crash would see it: bytes got since the last checkpoint
+ * come back on recovery, so they are not reused before it moves on.
+ */
+static uint32_t _FileFree(RingBufferFile *rbf)
+{
+    uint64_t used = rbf->rb.totalIn - rbf->hdr->checkpoint.totalOut;
+
+    return used < rbf->rb.size ? rbf->rb.size - 1 - (uint32_t)used : 0;
+}
+
+static RingBufferFileRecovery _FileRecover(RingBufferFile *rbf)
+{
+    RingBufferFileHeader *hdr = rbf->hdr;
+    RingBufferFileCheckpoint *cp = &hdr->checkpoint;
+    RingBufferFileRecovery recovery;
+    RingBuffer *rb = &rbf->rb;
+
+    /*
+     * Without a clean close the live indices may be ahead of what reached
+     * the disk, even when they look consistent: only the checkpoint is
+     * backed by synced data.
+     */
+    if (hdr->clean && _FileIndexValid(hdr->size, hdr->head, hdr->tail, hdr->totalIn, hdr->totalOut)) {
+        recovery = RINGBUFFER_FILE_CLEAN;
+        rb->head = hdr->head;
+        rb->tail = hdr->tail;
+        rb->totalIn = hdr->totalIn;
+        rb->totalOut = hdr->totalOut;
+    } else if (cp->checksum == _FileChecksum(cp) &&
+               _FileIndexValid(hdr->size, cp->head, cp->tail, cp->totalIn, cp->totalOut)) {
+        recovery = RINGBUFFER_FILE_CHECKPOINT;
+        rb->head = cp->head;
+        rb->tail = cp->tail;
+        rb->totalIn = cp->totalIn;
+        rb->totalOut = cp->totalOut;
+    } else {
+        recovery = RINGBUFFER_FILE_RESET;
+    }
+
+    return recovery;
+}
+
+int RingBufferFileOpen(RingBufferFile *rbf, const char *path, uint32_t size, RingBufferFileRecovery *recovery)
+{
+    RingBufferFileHeader *hdr;
+    RingBufferFileRecovery result;
+    struct stat st;
+    uint64_t page;
+    uint64_t mapSize;
+    void *addr;
+    int status;
+    int fd;
+
+    if (rbf == nullptr || path == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    RB_MEMSET(rbf, 0, sizeof(*rbf));
+    rbf->fd = -1;
+
+    fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return RB_ERROR_SYSTEM;
+    }
+    if (fstat(fd, &st) != 0) {
+        status = RB_ERROR_SYSTEM;
+        goto err_fd;
+    }
+
+    page = (uint64_t)sysconf(_SC_PAGESIZE);
+    if (st.st_size == 0) {
+        if (size < 2) {
+            status = RB_ERROR_PARAM;
+            goto err_fd;
+        }
+        mapSize = page + ((size + page - 1) & ~(page - 1));
+        if (ftruncate(fd, (off_t)mapSize) != 0) {
+            status = RB_ERROR_SYSTEM;
+            goto err_fd;
+        }
+    } else {
+        mapSize = (uint64_t)st.st_size;
+        if (mapSize < page) {
+            status = RB_ERROR_INVALID;
+            goto err_fd;
+        }
+    }
+
+    addr = mmap(nullptr, (size_t)mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        status = RB_ERROR_SYSTEM;
+        goto err_fd;
+    }
+    hdr = (RingBufferFileHeader *)addr;
+
+    if (st.st_size == 0) {
+        hdr->version = FILE_VERSION;
+        hdr->size = size;
+        hdr->dataOffset = (uint32_t)page;
+        hdr->clean = 1;
+        hdr->magic = FILE_MAGIC;
+    } else if (hdr->magic != FILE_MAGIC || hdr->version != FILE_VERSION ||
+               hdr->size < 2 || hdr->dataOffset < sizeof(RingBufferFileHeader) ||
+               (uint64_t)hdr->dataOffset + hdr->size > mapSize ||
+               (size != 0 && size != hdr->size)) {
+        status = RB_ERROR_INVALID;
+        goto err_map;
+    }
+
+    status = RingBufferInit(&rbf->rb, (uint8_t *)addr + hdr->dataOffset, hdr->size);
+    if (status) {
+        goto err_map;
+    }
+
+    rbf->hdr = hdr;
+    rbf->fd = fd;
+    rbf->mapSize = mapSize;
+
+    result = (st.st_size == 0) ? RINGBUFFER_FILE_NEW : _FileRecover(rbf);
+
+    /* Start the session from a consistent checkpoint, marked as not closed */
+    _FileLiveUpdate(rbf);
+    rbf->syncedTail = rbf->rb.tail;
+    rbf->syncedIn = rbf->rb.totalIn;
+    rbf->syncedTime = _FileNowMs();
+    _FileCheckpointWrite(rbf, rbf->rb.tail, rbf->rb.totalIn);
+    hdr->clean = 0;
+    _FileMsync(rbf, 0, sizeof(RingBufferFileHeader));
+
+    if (recovery) {
+        *recovery = result;
+    }
+
+    return RB_OK;
+
+err_map:
+    munmap(addr, (size_t)mapSize);
+err_fd:
+    close(fd);
+    return status;
+}
+
+int RingBufferFileClose(RingBufferFile *rbf)
+{
+    if (rbf == nullptr || rbf->hdr == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    RingBufferFileSync(rbf);
+    _FileLiveUpdate(rbf);
+    rbf->hdr->clean = 1;
+    _FileMsync(rbf, 0, sizeof(RingBufferFileHeader));
+
+    munmap(rbf->hdr, (size_t)rbf->mapSize);
+    close(rbf->fd);
+
+    RingBufferDeinit(&rbf->rb);
+    RB_MEMSET(rbf, 0, sizeof(*rbf));
+    rbf->fd = -1;
+
+    return RB_OK;
+}
+
+int RingBufferFileSyncPolicySet(RingBufferFile *rbf, uint32_t syncBytes, uint32_t syncMs)
+{
+    if (rbf == nullptr || rbf->hdr == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    rbf->syncBytes = syncBytes;
+    rbf->syncMs = syncMs;
+
+    return RB_OK;
+}
+
+int RingBufferFileSync(RingBufferFile *rbf)
+{
+    uint64_t len;
+    uint32_t tail;
+    uint64_t totalIn;
+    uint32_t size;
+
+    if (rbf == nullptr || rbf->hdr == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    size = rbf->rb.size;
+    tail = rbf->rb.tail;
+    totalIn = rbf->rb.totalIn;
+
+    /* Data first, the checkpoint must never point past what is on disk */
+    len = totalIn - rbf->syncedIn;
+    if (len >= size) {
+        _FileMsync(rbf, rbf->hdr->dataOffset, size);
+    } else if (rbf->syncedTail + len <= size) {
+        _FileMsync(rbf, rbf->hdr->dataOffset + rbf->syncedTail, len);
+    } else {
+        _FileMsync(rbf, rbf->hdr->dataOffset + rbf->syncedTail, size - rbf->syncedTail);
+        _FileMsync(rbf, rbf->hdr->dataOffset, len - (size - rbf->syncedTail));
+    }
+
+    _FileCheckpointWrite(rbf, tail, totalIn);
+
+    rbf->syncedTail = tail;
+    rbf->syncedIn = totalIn;
+    rbf->syncedTime = rbf->syncMs ? _FileNowMs() : 0;
+
+    return RB_OK;
+}
+
+uint32_t RingBufferFilePut(RingBufferFile *rbf, uint8_t *data, uint32_t size)
+{
+    uint32_t len;
+
+    if (rbf == nullptr || rbf->hdr == nullptr) {
+        return 0;
+    }
+
+    /* Reusing space the consumer freed needs its head checkpointed first */
+    if (size > _FileFree(rbf) && rbf->rb.totalOut != rbf->hdr->checkpoint.totalOut) {
+        RingBufferFileSync(rbf);
+    }
+    if (size > _FileFree(rbf)) {
+        size = _FileFree(rbf);
+    }
+    if (size == 0) {
+        return 0;
+    }
+
+    len = RingBufferPut(&rbf->rb, data, size);
+    if (len == 0) {
+        return 0;
+    }
+
+    rbf->hdr->tail = rbf->rb.tail;
+    rbf->hdr->totalIn = rbf->rb.totalIn;
+
+    if (rbf->syncBytes && rbf->rb.totalIn - rbf->syncedIn >= rbf->syncBytes) {
+        RingBufferFileSync(rbf);
+    } else if (rbf->syncMs && _FileNowMs() - rbf->syncedTime >= rbf->syncMs) {
+        RingBufferFileSync(rbf);
+    }
+
+    return len;
+}
+
+uint32_t RingBufferFileGet(RingBufferFile *rbf, uint8_t *data, uint32_t size)
+{
+    uint32_t len;
+
+    if (rbf == nullptr || rbf->hdr == nullptr) {
+        return 0;
+    }
+
+    len = RingBufferGet(&rbf->rb, data, size);
+    if (len == 0) {
+        return 0;
+    }
+
+    rbf->hdr->head = rbf->rb.head;
+    rbf->hdr->totalOut = rbf->rb.totalOut;
+
+    return len;
+}
+
+#endif  /* RINGBUFFER_USE_FILE && __linux__ */
@@ -0,0 +1,96 @@
+#ifndef __RINGBUFFER_FILE_H__
+#define __RINGBUFFER_FILE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "RingBuffer.h"
+
+#if RINGBUFFER_USE_FILE && defined(__linux__)
+
+/*
+ * Persistent ring backed by a memory-mapped file.
+ *
+ * The data and a one page header holding head, tail, totalIn and totalOut
+ * live in the file, so whatever is still queued survives a restart of the
+ * process. The live indices are updated on every put/get; at each sync
+ * point the data written since the last one is flushed with msync and a
+ * checksummed checkpoint of the indices is written behind it.
+ *
+ * On reopen the live indices are used only after a clean close. Otherwise
+ * the ring falls back to the last checkpoint, or starts empty when its
+ * checksum does not match: only data put before the last sync point is
+ * recovered, and data got after it is delivered again. Until a sync has
+ * checkpointed the consumer's head, the space it frees is not reused; a
+ * put that needs it syncs first.
+ *
+ * Single producer and single consumer, syncs run on the producer side.
+ */
+
+typedef enum {
+    RINGBUFFER_FILE_NEW = 0U,           // File created
+    RINGBUFFER_FILE_CLEAN,              // Closed cleanly, live indices used
+    RINGBUFFER_FILE_RECOVERED,          // No longer returned, live indices need a clean close
+    RINGBUFFER_FILE_CHECKPOINT,         // Not closed, rolled back to the last checkpoint
+    RINGBUFFER_FILE_RESET,              // Nothing usable, the ring starts empty
+} RingBufferFileRecovery;
+
+typedef struct {
+    uint32_t head;
+    uint32_t tail;
+    uint64_t totalIn;
+    uint64_t totalOut;
+    uint64_t seq;
+    uint32_t checksum;
+    uint32_t reserved;
+} RingBufferFileCheckpoint;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;
+    uint32_t dataOffset;                // Page aligned, from the start of the file
+    volatile uint32_t clean;
+
+    RingBufferFileCheckpoint checkpoint;
+
+    /* Live indices, mirrors of the ring */
+    RB_ALIGNED(RINGBUFFER_CACHE_LINE_SIZE) volatile uint32_t tail;
+    volatile uint64_t totalIn;
+
+    RB_ALIGNED(RINGBUFFER_CACHE_LINE_SIZE) volatile uint32_t head;
+    volatile uint64_t totalOut;
+} RingBufferFileHeader;
+
+typedef struct {
+    RingBuffer rb;
+    RingBufferFileHeader *hdr;
+
+    int fd;
+    uint64_t mapSize;
+
+    uint32_t syncBytes;                 // Sync after this much was put, 0 to disable
+    uint32_t syncMs;                    // Sync when the last one is this old, 0 to disable
+    uint32_t syncedTail;
+    uint64_t syncedIn;
+    uint64_t syncedTime;
+} RingBufferFile;
+
+/* size 0 takes the size of an existing file */
+int RingBufferFileOpen(RingBufferFile *rbf, const char *path, uint32_t size, RingBufferFileRecovery *recovery);
+int RingBufferFileClose(RingBufferFile *rbf);
+
+int RingBufferFileSyncPolicySet(RingBufferFile *rbf, uint32_t syncBytes, uint32_t syncMs);
+int RingBufferFileSync(RingBufferFile *rbf);
+
+uint32_t RingBufferFilePut(RingBufferFile *rbf, uint8_t *data, uint32_t size);
+uint32_t RingBufferFileGet(RingBufferFile *rbf, uint8_t *data, uint32_t size);
+
+#endif  /* RINGBUFFER_USE_FILE && __linux__ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__RINGBUFFER_FILE_H__
@@ -0,0 +1,192 @@
+#include "RingBufferLanes.h"
+
+#if RINGBUFFER_USE_LANES
+
+#ifndef nullptr
+#ifdef NULL
+#define nullptr NULL
+#else
+#define nullptr ((void *)0)
+#endif
+#endif
+
+#define LANES_NONE                      0xFFFFFFFFU
+
+/* Next lane at `priority` with data and credit left, starting at the cursor */
+static uint32_t _LanesNext(RingBufferLanes *lq, uint32_t priority, const uint32_t *len)
+{
+    RingBufferLane *l;
+    uint32_t i;
+    uint32_t id;
+
+    for (i = 0; i < lq->count; i++) {
+        id = (lq->cursor + i) % lq->count;
+        l = &lq->lane[id];
+        if (l->priority == priority && len[id] && l->credit) {
+            return id;
+        }
+    }
+
+    return LANES_NONE;
+}
+
+static uint32_t _LanesPick(RingBufferLanes *lq)
+{
+    uint32_t len[RINGBUFFER_LANES_MAX];
+    uint32_t priority = LANES_NONE;
+    uint32_t id;
+    uint32_t i;
+
+    for (i = 0; i < lq->count; i++) {
+        len[i] = RingBufferLenGet(lq->lane[i].rb);
+        if (len[i] > lq->lane[i].maxLen) {
+            lq->lane[i].maxLen = len[i];
+        }
+        if (len[i] && lq->lane[i].priority < priority) {
+            priority = lq->lane[i].priority;
+        }
+    }
+    if (priority == LANES_NONE) {
+        return LANES_NONE;
+    }
+
+    id = _LanesNext(lq, priority, len);
+    if (id == LANES_NONE) {
+        /* Round over at this level */
+        for (i = 0; i < lq->count; i++) {
+            if (lq->lane[i].priority == priority) {
+                lq->lane[i].credit = lq->lane[i].weight;
+            }
+        }
+        id = _LanesNext(lq, priority, len);
+    }
+
+    return id;
+}
+
+int RingBufferLanesInit(RingBufferLanes *lq)
+{
+    if (lq == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    RB_MEMSET(lq, 0, sizeof(*lq));
+
+    return RB_OK;
+}
+
+int RingBufferLanesAdd(RingBufferLanes *lq, RingBuffer *rb, uint32_t priority, uint32_t weight, uint32_t *id)
+{
+    RingBufferLane *l;
+
+    if (lq == nullptr || rb == nullptr || rb->buff == nullptr || rb->size <= 1) {
+        return RB_ERROR_PARAM;
+    }
+    if (priority == LANES_NONE) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->mode != RINGBUFFER_CPU_MODE) {
+        return RB_ERROR_INVALID;
+    }
+    if (lq->count >= RINGBUFFER_LANES_MAX) {
+        return RB_ERROR_LOCKED;
+    }
+
+    l = &lq->lane[lq->count];
+    RB_MEMSET(l, 0, sizeof(*l));
+    l->rb = rb;
+    l->priority = priority;
+    l->weight = weight ? weight : 1;
+    l->credit = l->weight;
+
+    if (id) {
+        *id = lq->count;
+    }
+    lq->count++;
+
+    return RB_OK;
+}
+
+uint32_t RingBufferLanesPut(RingBufferLanes *lq, uint32_t id, uint8_t *data, uint32_t size)
+{
+    RingBufferLane *l;
+    uint32_t len;
+
+    if (lq == nullptr || id >= lq->count || data == nullptr || size <= 0) {
+        return 0;
+    }
+    l = &lq->lane[id];
+
+    len = RingBufferPut(l->rb, data, size);
+    l->putBytes += len;
+    l->rejectedBytes += size - len;
+
+    return len;
+}
+
+uint32_t RingBufferLanesGet(RingBufferLanes *lq, uint8_t *data, uint32_t size, uint32_t *lane)
+{
+    RingBufferLane *l;
+    uint32_t id;
+    uint32_t len;
+
+    if (lq == nullptr || data == nullptr || size <= 0) {
+        return 0;
+    }
+
+    id = _LanesPick(lq);
+    if (id == LANES_NONE) {
+        return 0;
+    }
+    l = &lq->lane[id];
+
+    len = RingBufferGet(l->rb, data, size);
+    l->getBytes += len;
+    l->picks++;
+
+    /* Stay on the lane until its share of the round is used */
+    l->credit--;
+    lq->cursor = l->credit ? id : (id + 1) % lq->count;
+
+    if (lane) {
+        *lane = id;
+    }
+
+    return len;
+}
+
+uint32_t RingBufferLanesLenGet(RingBufferLanes *lq)
+{
+    uint32_t len = 0;
+    uint32_t i;
+
+    if (lq == nullptr) {
+        return 0;
+    }
+
+    for (i = 0; i < lq->count; i++) {
+        len += RingBufferLenGet(lq->lane[i].rb);
+    }
+
+    return len;
+}
+
+int RingBufferLanesStatGet(RingBufferLanes *lq, uint32_t id, RingBufferLaneStat *stat)
+{
+    RingBufferLane *l;
+
+    if (lq == nullptr || id >= lq->count || stat == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+    l = &lq->lane[id];
+
+    stat->putBytes = l->putBytes;
+    stat->rejectedBytes = l->rejectedBytes;
+    stat->getBytes = l->getBytes;
+    stat->picks = l->picks;
+    stat->maxLen = l->maxLen;
+
+    return RB_OK;
+}
+
+#endif  /* RINGBUFFER_USE_LANES */
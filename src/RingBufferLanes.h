@@ -0,0 +1,73 @@
+#ifndef __RINGBUFFER_LANES_H__
+#define __RINGBUFFER_LANES_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "RingBuffer.h"
+
+#if RINGBUFFER_USE_LANES
+
+/*
+ * Multi-lane queue: up to RINGBUFFER_LANES_MAX cpu mode rings, each fed by
+ * its own producer, drained by one consumer through RingBufferLanesGet().
+ *
+ * Lanes with a lower `priority` value are served strictly first. Lanes
+ * sharing a priority are served weighted round-robin, a lane gets `weight`
+ * Gets per round before the next non-empty one at that level. Giving every
+ * lane the same priority makes it plain WRR, distinct priorities make it
+ * strict priority.
+ *
+ * A Get reads from one lane only, so `size` bounds how long an urgent lane
+ * can wait behind a bulk one.
+ */
+
+typedef struct {
+    uint64_t putBytes;
+    uint64_t rejectedBytes;             // Not taken because the lane was full
+    uint64_t getBytes;
+    uint64_t picks;
+    uint32_t maxLen;                    // High watermark seen by the consumer
+} RingBufferLaneStat;
+
+typedef struct {
+    RingBuffer *rb;
+    uint32_t priority;
+    uint32_t weight;
+    uint32_t credit;
+
+    /* Producer side */
+    RB_ALIGNED(RINGBUFFER_CACHE_LINE_SIZE) uint64_t putBytes;
+    uint64_t rejectedBytes;
+
+    /* Consumer side */
+    RB_ALIGNED(RINGBUFFER_CACHE_LINE_SIZE) uint64_t getBytes;
+    uint64_t picks;
+    uint32_t maxLen;
+} RingBufferLane;
+
+typedef struct {
+    uint32_t count;
+    uint32_t cursor;                    // Lane the round-robin continues from
+    RingBufferLane lane[RINGBUFFER_LANES_MAX];
+} RingBufferLanes;
+
+int RingBufferLanesInit(RingBufferLanes *lq);
+/* Lanes are added before any traffic, weight 0 counts as 1 */
+int RingBufferLanesAdd(RingBufferLanes *lq, RingBuffer *rb, uint32_t priority, uint32_t weight, uint32_t *id);
+
+uint32_t RingBufferLanesPut(RingBufferLanes *lq, uint32_t id, uint8_t *data, uint32_t size);
+/* Reads from the lane the scheduler picks, `lane` may be nullptr */
+uint32_t RingBufferLanesGet(RingBufferLanes *lq, uint8_t *data, uint32_t size, uint32_t *lane);
+
+uint32_t RingBufferLanesLenGet(RingBufferLanes *lq);
+int RingBufferLanesStatGet(RingBufferLanes *lq, uint32_t id, RingBufferLaneStat *stat);
+
+#endif  /* RINGBUFFER_USE_LANES */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__RINGBUFFER_LANES_H__
@@ -0,0 +1,421 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "RingBufferPipeline.h"
+
+#if RINGBUFFER_USE_PIPELINE && defined(__linux__)
+
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef nullptr
+#ifdef NULL
+#define nullptr NULL
+#else
+#define nullptr ((void *)0)
+#endif
+#endif
+
+static uint64_t _PipelineNowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t _PipelineSpace(RingBuffer *rb)
+{
+    return RingBufferSpaceGet(rb);
+}
+
+/*
+ * Polls until `need` bytes (of data, or of space) are there, until the
+ * spin budget is spent and at least one is, or until the peer stage or the
+ * pipeline is finished. Returns what is available then.
+ */
+static uint32_t _PipelineWait(
+    RingBufferPipelineStage *st,
+    RingBuffer *rb,
+    int space,
+    uint32_t need,
+    volatile uint32_t *peerDone,
+    uint64_t *times,
+    uint64_t *ns
+)
+{
+    RingBufferPipeline *pl = st->pl;
+    uint64_t start = 0;
+    uint32_t n;
+    uint32_t i;
+
+    for (i = 0; ; i++) {
+        n = space ? _PipelineSpace(rb) : RingBufferLenGet(rb);
+        if (n >= need || (n && i >= pl->spin)) {
+            break;
+        }
+        if (*peerDone || pl->abort) {
+            /* The last bytes land before the done flag */
+            RB_MEMORY_BARRIER();
+            n = space ? _PipelineSpace(rb) : RingBufferLenGet(rb);
+            break;
+        }
+
+        if (i == 0) {
+            start = _PipelineNowNs();
+            (*times)++;
+        }
+        if (i < pl->spin) {
+            continue;
+        }
+        if (pl->sleepUs) {
+            usleep(pl->sleepUs);
+        } else {
+            sched_yield();
+        }
+    }
+
+    if (start) {
+        *ns += _PipelineNowNs() - start;
+    }
+
+    return n;
+}
+
+/*
+ * After a call that used nothing: polls until the input holds more than
+ * `inLen` or the output has more than `outCap` free, or a neighbour or the
+ * pipeline is finished. A ring that cannot grow (input full or past
+ * eof, where `upDone` is nullptr, output empty) is not waited on; with
+ * neither able to, backs off once. The wait counts as blocked when more
+ * output space ends it, or when only the output could grow, else as
+ * starved.
+ */
+static void _PipelineStall(
+    RingBufferPipelineStage *st,
+    uint32_t inLen,
+    uint32_t outCap,
+    volatile uint32_t *upDone,
+    volatile uint32_t *downDone
+)
+{
+    RingBufferPipeline *pl = st->pl;
+    int waitIn = upDone && inLen < st->in->size - 1;
+    int waitOut = st->out && outCap < st->out->size - 1;
+    int blocked = waitOut && !waitIn;
+    uint64_t start = _PipelineNowNs();
+    uint32_t i;
+
+    for (i = 0; ; i++) {
+        if (waitIn && RingBufferLenGet(st->in) > inLen) {
+            blocked = 0;
+            break;
+        }
+        if (waitOut && _PipelineSpace(st->out) > outCap) {
+            blocked = 1;
+            break;
+        }
+        if ((upDone && *upDone) || (downDone && *downDone) || pl->abort) {
+            break;
+        }
+        if (!waitIn && !waitOut && i > pl->spin) {
+            break;
+        }
+
+        if (i < pl->spin) {
+            continue;
+        }
+        if (pl->sleepUs) {
+            usleep(pl->sleepUs);
+        } else {
+            sched_yield();
+        }
+    }
+
+    if (blocked) {
+        st->blockedTimes++;
+        st->blockedNs += _PipelineNowNs() - start;
+    } else {
+        st->starvedTimes++;
+        st->starvedNs += _PipelineNowNs() - start;
+    }
+}
+
+static void _PipelineStageRun(RingBufferPipelineStage *st, uint32_t id)
+{
+    RingBufferPipeline *pl = st->pl;
+    volatile uint32_t *upDone = id > 0 ? &pl->stage[id - 1].done : nullptr;
+    volatile uint32_t *downDone = id + 1 < pl->count ? &pl->stage[id + 1].done : nullptr;
+    RingBufferStageIo io;
+    uint32_t len;
+    uint32_t head = 0;
+    uint32_t tail = 0;
+    uint32_t upFinished;
+    int status;
+
+    while (!pl->abort) {
+        RB_MEMSET(&io, 0, sizeof(io));
+
+        if (st->in) {
+            upFinished = *upDone;
+            RB_MEMORY_BARRIER();
+            len = _PipelineWait(st, st->in, 0, pl->batch < st->in->size ? pl->batch : st->in->size - 1,
+                                upDone, &st->starvedTimes, &st->starvedNs);
+            if (pl->abort) {
+                break;
+            }
+            if (!upFinished && *upDone) {
+                /* Finished while waiting, look again for its last bytes */
+                continue;
+            }
+
+            RB_MEMORY_BARRIER();
+            head = st->in->head;
+            io.in = &st->in->buff[head];
+            io.inLen = len < st->in->size - head ? len : st->in->size - head;
+            if (len > io.inLen) {
+                io.in2 = st->in->buff;
+                io.inLen2 = len - io.inLen;
+            }
+            /* Both segments hold everything upstream will ever write */
+            io.eof = upFinished;
+        }
+
+        if (st->out) {
+            len = _PipelineWait(st, st->out, 1, pl->batch < st->out->size ? pl->batch : st->out->size - 1,
+                                downDone, &st->blockedTimes, &st->blockedNs);
+            if (pl->abort || *downDone) {
+                break;
+            }
+
+            tail = st->out->tail;
+            io.out = &st->out->buff[tail];
+            io.outCap = len < st->out->size - tail ? len : st->out->size - tail;
+            if (len > io.outCap) {
+                io.out2 = st->out->buff;
+                io.outCap2 = len - io.outCap;
+            }
+        }
+
+        status = st->fn(st->ctx, &io);
+        st->calls++;
+        if (status < 0 || io.consumed > io.inLen + io.inLen2 ||
+            io.produced > io.outCap + io.outCap2) {
+            st->status = status < 0 ? status : RB_ERROR_INVALID;
+            pl->abort = 1;
+            break;
+        }
+
+        /* Stage reads and writes are done before the indexes move */
+        RB_MEMORY_BARRIER();
+        if (io.produced) {
+            st->out->tail = (tail + io.produced) % st->out->size;
+            st->out->totalIn += io.produced;
+            st->out->dataHasPut = 1;
+            st->bytesOut += io.produced;
+        }
+        if (io.consumed) {
+            st->in->head = (head + io.consumed) % st->in->size;
+            st->in->totalOut += io.consumed;
+            st->bytesIn += io.consumed;
+        }
+
+        if (status == RINGBUFFER_STAGE_DONE) {
+            break;
+        }
+        if (io.consumed == 0 && io.produced == 0) {
+            /* Past eof only more output space can get it going */
+            if (io.eof && (st->out == nullptr || io.outCap + io.outCap2 >= st->out->size - 1)) {
+                break;
+            }
+            _PipelineStall(st, io.inLen + io.inLen2, io.outCap + io.outCap2,
+                           io.eof ? nullptr : upDone, downDone);
+        }
+    }
+}
+
+static void *_PipelineThread(void *arg)
+{
+    RingBufferPipelineStage *st = (RingBufferPipelineStage *)arg;
+    RingBufferPipeline *pl = st->pl;
+    cpu_set_t set;
+
+    if (st->cpu >= 0) {
+        CPU_ZERO(&set);
+        CPU_SET(st->cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    st->startNs = _PipelineNowNs();
+    _PipelineStageRun(st, (uint32_t)(st - &pl->stage[0]));
+    st->endNs = _PipelineNowNs();
+
+    RB_MEMORY_BARRIER();
+    st->done = 1;
+
+    return nullptr;
+}
+
+int RingBufferPipelineInit(RingBufferPipeline *pl, uint32_t batch, uint32_t spin, uint32_t sleepUs)
+{
+    if (pl == nullptr || batch <= 0) {
+        return RB_ERROR_PARAM;
+    }
+
+    RB_MEMSET(pl, 0, sizeof(*pl));
+    pl->batch = batch;
+    pl->spin = spin;
+    pl->sleepUs = sleepUs;
+
+    return RB_OK;
+}
+
+int RingBufferPipelineDeinit(RingBufferPipeline *pl)
+{
+    uint32_t i;
+
+    if (pl == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    for (i = 0; i < pl->count; i++) {
+        if (pl->stage[i].started && !pl->stage[i].done) {
+            return RB_ERROR_LOCKED;
+        }
+    }
+    /* Finished without a Wait, the threads still need joining */
+    for (i = 0; i < pl->count; i++) {
+        if (pl->stage[i].started) {
+            pthread_join(pl->stage[i].thread, nullptr);
+            pl->stage[i].started = 0;
+        }
+    }
+    for (i = 0; i + 1 < pl->count; i++) {
+        RingBufferDelete(&pl->ring[i]);
+    }
+
+    RB_MEMSET(pl, 0, sizeof(*pl));
+
+    return RB_OK;
+}
+
+int RingBufferPipelineStageAdd(RingBufferPipeline *pl, RINGBUFFER_STAGE fn, void *ctx, uint32_t ringSize, int cpu)
+{
+    RingBufferPipelineStage *st;
+    int status;
+
+    if (pl == nullptr || fn == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+    if (pl->count >= RINGBUFFER_PIPELINE_STAGES) {
+        return RB_ERROR_LOCKED;
+    }
+    if (pl->count > 0 && ringSize < 2) {
+        return RB_ERROR_PARAM;
+    }
+
+    st = &pl->stage[pl->count];
+    RB_MEMSET(st, 0, sizeof(*st));
+
+    if (pl->count > 0) {
+        status = RingBufferCreate(&pl->ring[pl->count - 1], ringSize);
+        if (status) {
+            return status;
+        }
+        st->in = &pl->ring[pl->count - 1];
+        pl->stage[pl->count - 1].out = st->in;
+    }
+
+    st->fn = fn;
+    st->ctx = ctx;
+    st->cpu = cpu;
+    st->ringSize = ringSize;
+    st->pl = pl;
+    pl->count++;
+
+    return RB_OK;
+}
+
+int RingBufferPipelineStart(RingBufferPipeline *pl)
+{
+    uint32_t i;
+
+    if (pl == nullptr || pl->count < 2) {
+        return RB_ERROR_PARAM;
+    }
+
+    for (i = 0; i < pl->count; i++) {
+        if (pthread_create(&pl->stage[i].thread, nullptr, _PipelineThread, &pl->stage[i]) != 0) {
+            pl->abort = 1;
+            RingBufferPipelineWait(pl);
+            return RB_ERROR_SYSTEM;
+        }
+        pl->stage[i].started = 1;
+    }
+
+    return RB_OK;
+}
+
+int RingBufferPipelineStop(RingBufferPipeline *pl)
+{
+    if (pl == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    pl->abort = 1;
+
+    return RB_OK;
+}
+
+int RingBufferPipelineWait(RingBufferPipeline *pl)
+{
+    int status = RB_OK;
+    uint32_t i;
+
+    if (pl == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    for (i = 0; i < pl->count; i++) {
+        if (pl->stage[i].started) {
+            pthread_join(pl->stage[i].thread, nullptr);
+            pl->stage[i].started = 0;
+        }
+        if (status == RB_OK) {
+            status = pl->stage[i].status;
+        }
+    }
+
+    return status;
+}
+
+int RingBufferPipelineStatGet(RingBufferPipeline *pl, uint32_t id, RingBufferStageStat *stat)
+{
+    RingBufferPipelineStage *st;
+    uint64_t end;
+
+    if (pl == nullptr || id >= pl->count || stat == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+    st = &pl->stage[id];
+
+    end = st->done ? st->endNs : _PipelineNowNs();
+
+    stat->bytesIn = st->bytesIn;
+    stat->bytesOut = st->bytesOut;
+    stat->calls = st->calls;
+    stat->starvedTimes = st->starvedTimes;
+    stat->starvedNs = st->starvedNs;
+    stat->blockedTimes = st->blockedTimes;
+    stat->blockedNs = st->blockedNs;
+    stat->elapsedNs = st->startNs ? end - st->startNs : 0;
+    stat->busyNs = stat->elapsedNs > st->starvedNs + st->blockedNs ?
+                   stat->elapsedNs - st->starvedNs - st->blockedNs : 0;
+    stat->status = st->status;
+
+    return RB_OK;
+}
+
+#endif  /* RINGBUFFER_USE_PIPELINE && __linux__ */
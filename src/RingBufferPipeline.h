@@ -0,0 +1,123 @@
+#ifndef __RINGBUFFER_PIPELINE_H__
+#define __RINGBUFFER_PIPELINE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "RingBuffer.h"
+
+#if RINGBUFFER_USE_PIPELINE && defined(__linux__)
+
+#include <pthread.h>
+
+/*
+ * Pipeline of up to RINGBUFFER_PIPELINE_STAGES stages, each on its own
+ * worker thread, chained by rings the runtime allocates. The first stage
+ * only produces, the last only consumes.
+ *
+ * A stage works in place: it gets the readable part of its input ring and
+ * the free part of its output ring, each as up to two segments because
+ * of the wrap (`in` then `in2`, `out` then `out2`), and reports how much
+ * of each it used, counted across both segments. A stage that only looks
+ * at the first segments still works, but a record crossing the wrap then
+ * never fits. It returns RB_OK to be called again, RINGBUFFER_STAGE_DONE
+ * when it has finished, or a negative error which stops the whole
+ * pipeline. `eof` tells it the input holds the last bytes the upstream
+ * stage will ever produce; called with eof, a stage that does not answer
+ * DONE and makes no progress is finished anyway.
+ *
+ * Every stage waits the same way: it runs once `batch` bytes (of input
+ * and of output space) are there, polls up to `spin` times for them, then
+ * takes whatever is non-empty and otherwise sleeps `sleepUs` per poll
+ * (0 yields instead). A call that used nothing is not repeated until more
+ * input or more output space has arrived.
+ */
+
+#define RINGBUFFER_STAGE_DONE           1
+
+typedef struct {
+    const uint8_t *in;                  // nullptr for the first stage
+    uint32_t inLen;
+    const uint8_t *in2;                 // Continues `in` after the wrap
+    uint32_t inLen2;
+    uint8_t *out;                       // nullptr for the last stage
+    uint32_t outCap;
+    uint8_t *out2;                      // Continues `out` after the wrap
+    uint32_t outCap2;
+    uint32_t eof;
+
+    uint32_t consumed;                  // Set by the stage
+    uint32_t produced;
+} RingBufferStageIo;
+
+typedef int (*RINGBUFFER_STAGE)(void *ctx, RingBufferStageIo *io);
+
+typedef struct {
+    uint64_t bytesIn;
+    uint64_t bytesOut;
+    uint64_t calls;
+    uint64_t starvedTimes;              // Waits for input
+    uint64_t starvedNs;
+    uint64_t blockedTimes;              // Waits for output space, back-pressure
+    uint64_t blockedNs;
+    uint64_t elapsedNs;
+    uint64_t busyNs;                    // Elapsed without waits, the bottleneck is the busiest stage
+    int status;
+} RingBufferStageStat;
+
+typedef struct {
+    RINGBUFFER_STAGE fn;
+    void *ctx;
+    int cpu;                            // -1 leaves the thread unpinned
+    uint32_t ringSize;                  // Of the ring feeding this stage
+
+    struct RingBufferPipeline *pl;
+    RingBuffer *in;
+    RingBuffer *out;
+    pthread_t thread;
+    uint32_t started;
+    volatile uint32_t done;
+    int status;
+
+    uint64_t bytesIn;
+    uint64_t bytesOut;
+    uint64_t calls;
+    uint64_t starvedTimes;
+    uint64_t starvedNs;
+    uint64_t blockedTimes;
+    uint64_t blockedNs;
+    uint64_t startNs;
+    volatile uint64_t endNs;
+} RingBufferPipelineStage;
+
+typedef struct RingBufferPipeline {
+    uint32_t count;
+    uint32_t batch;
+    uint32_t spin;
+    uint32_t sleepUs;
+    volatile uint32_t abort;
+
+    RingBufferPipelineStage stage[RINGBUFFER_PIPELINE_STAGES];
+    RingBuffer ring[RINGBUFFER_PIPELINE_STAGES - 1];
+} RingBufferPipeline;
+
+int RingBufferPipelineInit(RingBufferPipeline *pl, uint32_t batch, uint32_t spin, uint32_t sleepUs);
+int RingBufferPipelineDeinit(RingBufferPipeline *pl);   // RB_ERROR_LOCKED while a stage still runs
+
+/* Appends a stage, `ringSize` is ignored for the first one */
+int RingBufferPipelineStageAdd(RingBufferPipeline *pl, RINGBUFFER_STAGE fn, void *ctx, uint32_t ringSize, int cpu);
+
+int RingBufferPipelineStart(RingBufferPipeline *pl);
+int RingBufferPipelineStop(RingBufferPipeline *pl);     // Asks every stage to quit, Wait joins them
+int RingBufferPipelineWait(RingBufferPipeline *pl);     // First stage error, or RB_OK
+
+int RingBufferPipelineStatGet(RingBufferPipeline *pl, uint32_t id, RingBufferStageStat *stat);
+
+#endif  /* RINGBUFFER_USE_PIPELINE && __linux__ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__RINGBUFFER_PIPELINE_H__
@@ -0,0 +1,208 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "RingBufferShard.h"
+
+#if RINGBUFFER_USE_SHARD && defined(__linux__)
+
+#include <sched.h>
+#include <unistd.h>
+
+#ifndef nullptr
+#ifdef NULL
+#define nullptr NULL
+#else
+#define nullptr ((void *)0)
+#endif
+#endif
+
+#define SHARD_NONE                      0xFFFFFFFFU
+
+static uint32_t _ShardPickRoundRobin(RingBufferShardSet *set)
+{
+    uint32_t i;
+    uint32_t id;
+
+    for (i = 0; i < set->count; i++) {
+        id = (set->cursor + i) % set->count;
+        if (RingBufferLenGet(&set->shard[id].rb)) {
+            return id;
+        }
+    }
+
+    return SHARD_NONE;
+}
+
+static uint32_t _ShardPickOccupancy(RingBufferShardSet *set)
+{
+    uint32_t best = SHARD_NONE;
+    uint32_t max = 0;
+    uint32_t len;
+    uint32_t i;
+    uint32_t id;
+
+    /* Start at the cursor so equal shards still take turns */
+    for (i = 0; i < set->count; i++) {
+        id = (set->cursor + i) % set->count;
+        len = RingBufferLenGet(&set->shard[id].rb);
+        if (len > max) {
+            max = len;
+            best = id;
+        }
+    }
+
+    return best;
+}
+
+int RingBufferShardSetCreate(RingBufferShardSet *set, uint32_t count, uint32_t shardSize, RingBufferShardPolicy policy)
+{
+    long cpus;
+    uint32_t i;
+    int status;
+
+    if (set == nullptr || shardSize < 2) {
+        return RB_ERROR_PARAM;
+    }
+    if (policy != RINGBUFFER_SHARD_ROUND_ROBIN && policy != RINGBUFFER_SHARD_OCCUPANCY) {
+        return RB_ERROR_PARAM;
+    }
+    if (count == 0) {
+        cpus = sysconf(_SC_NPROCESSORS_CONF);
+        count = cpus > 0 ? (uint32_t)cpus : 1;
+        if (count > RINGBUFFER_SHARD_MAX) {
+            count = RINGBUFFER_SHARD_MAX;
+        }
+    }
+    if (count > RINGBUFFER_SHARD_MAX) {
+        return RB_ERROR_PARAM;
+    }
+
+    RB_MEMSET(set, 0, sizeof(*set));
+    for (i = 0; i < count; i++) {
+        status = RingBufferCreate(&set->shard[i].rb, shardSize);
+        if (status) {
+            while (i--) {
+                RingBufferDelete(&set->shard[i].rb);
+            }
+            return status;
+        }
+    }
+
+    set->count = count;
+    set->policy = policy;
+
+    return RB_OK;
+}
+
+int RingBufferShardSetDelete(RingBufferShardSet *set)
+{
+    uint32_t i;
+
+    if (set == nullptr || set->count == 0) {
+        return RB_ERROR_PARAM;
+    }
+
+    for (i = 0; i < set->count; i++) {
+        RingBufferDelete(&set->shard[i].rb);
+    }
+
+    RB_MEMSET(set, 0, sizeof(*set));
+
+    return RB_OK;
+}
+
+int RingBufferShardProducerAttach(RingBufferShardSet *set, RingBufferShardProducer *prod)
+{
+    uint32_t start;
+    uint32_t i;
+    uint32_t id;
+    int cpu;
+
+    if (set == nullptr || set->count == 0 || prod == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    cpu = sched_getcpu();
+    start = cpu >= 0 ? (uint32_t)cpu % set->count : 0;
+
+    for (i = 0; i < set->count; i++) {
+        id = (start + i) % set->count;
+        if (RB_ATOMIC_CAS(&set->shard[id].owned, 0U, 1U)) {
+            prod->set = set;
+            prod->id = id;
+            return RB_OK;
+        }
+    }
+
+    return RB_ERROR_LOCKED;
+}
+
+int RingBufferShardProducerDetach(RingBufferShardProducer *prod)
+{
+    if (prod == nullptr || prod->set == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    /* Puts of this thread are visible before the next owner starts */
+    RB_MEMORY_BARRIER();
+    prod->set->shard[prod->id].owned = 0;
+    prod->set = nullptr;
+
+    return RB_OK;
+}
+
+uint32_t RingBufferShardPut(RingBufferShardProducer *prod, uint8_t *data, uint32_t size)
+{
+    if (prod == nullptr || prod->set == nullptr) {
+        return 0;
+    }
+
+    return RingBufferPut(&prod->set->shard[prod->id].rb, data, size);
+}
+
+uint32_t RingBufferShardGet(RingBufferShardSet *set, uint8_t *data, uint32_t size, uint32_t *shard)
+{
+    uint32_t id;
+    uint32_t len;
+
+    if (set == nullptr || set->count == 0 || data == nullptr || size <= 0) {
+        return 0;
+    }
+
+    if (set->policy == RINGBUFFER_SHARD_OCCUPANCY) {
+        id = _ShardPickOccupancy(set);
+    } else {
+        id = _ShardPickRoundRobin(set);
+    }
+    if (id == SHARD_NONE) {
+        return 0;
+    }
+
+    len = RingBufferGet(&set->shard[id].rb, data, size);
+    set->cursor = (id + 1) % set->count;
+
+    if (shard) {
+        *shard = id;
+    }
+
+    return len;
+}
+
+uint64_t RingBufferShardLenGet(RingBufferShardSet *set)
+{
+    uint64_t len = 0;
+    uint32_t i;
+
+    if (set == nullptr) {
+        return 0;
+    }
+
+    for (i = 0; i < set->count; i++) {
+        len += RingBufferLenGet(&set->shard[i].rb);
+    }
+
+    return len;
+}
+
+#endif  /* RINGBUFFER_USE_SHARD && __linux__ */
@@ -0,0 +1,66 @@
+#ifndef __RINGBUFFER_SHARD_H__
+#define __RINGBUFFER_SHARD_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "RingBuffer.h"
+
+#if RINGBUFFER_USE_SHARD && defined(__linux__)
+
+/*
+ * Sharded ring set: one SPSC ring per core instead of one ring shared by
+ * every producer, so producers never write a cache line another producer
+ * writes.
+ *
+ * A producer thread attaches once and gets the shard of the core it runs
+ * on, or the next free one when that is taken; the shard stays its own
+ * until it detaches, also if the thread migrates. One aggregator drains
+ * the set with RingBufferShardGet(), each call reads a batch from a single
+ * shard, so records from different producers never interleave.
+ */
+
+typedef enum {
+    RINGBUFFER_SHARD_ROUND_ROBIN = 0U,  // Next non-empty shard after the last one read
+    RINGBUFFER_SHARD_OCCUPANCY,         // Fullest shard first
+} RingBufferShardPolicy;
+
+typedef struct {
+    RingBuffer rb;
+    volatile uint32_t owned;
+} RingBufferShard;
+
+typedef struct {
+    uint32_t count;
+    RingBufferShardPolicy policy;
+    uint32_t cursor;
+
+    RingBufferShard shard[RINGBUFFER_SHARD_MAX];
+} RingBufferShardSet;
+
+/* Producer-side handle, one per thread */
+typedef struct {
+    RingBufferShardSet *set;
+    uint32_t id;
+} RingBufferShardProducer;
+
+/* count 0 takes one shard per configured cpu */
+int RingBufferShardSetCreate(RingBufferShardSet *set, uint32_t count, uint32_t shardSize, RingBufferShardPolicy policy);
+int RingBufferShardSetDelete(RingBufferShardSet *set);
+
+int RingBufferShardProducerAttach(RingBufferShardSet *set, RingBufferShardProducer *prod);  // RB_ERROR_LOCKED when all are taken
+int RingBufferShardProducerDetach(RingBufferShardProducer *prod);
+uint32_t RingBufferShardPut(RingBufferShardProducer *prod, uint8_t *data, uint32_t size);
+
+/* Reads up to `size` bytes from the shard the policy picks, `shard` may be nullptr */
+uint32_t RingBufferShardGet(RingBufferShardSet *set, uint8_t *data, uint32_t size, uint32_t *shard);
+uint64_t RingBufferShardLenGet(RingBufferShardSet *set);
+
+#endif  /* RINGBUFFER_USE_SHARD && __linux__ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__RINGBUFFER_SHARD_H__
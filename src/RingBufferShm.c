@@ -0,0 +1,584 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "RingBufferShm.h"
+
+#if RINGBUFFER_USE_SHM && defined(__linux__)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#ifndef nullptr
+#ifdef NULL
+#define nullptr NULL
+#else
+#define nullptr ((void *)0)
+#endif
+#endif
+
+#define SHM_MAGIC                       0x52425348U     // "RBSH"
+#define SHM_VERSION                     1U
+
+static int _ShmFutexWait(volatile uint32_t *addr, uint32_t val, const struct timespec *deadline)
+{
+    /* Shared futex: no FUTEX_PRIVATE_FLAG, the waker is another process */
+    if (syscall(SYS_futex, addr, FUTEX_WAIT_BITSET, val, deadline, nullptr, FUTEX_BITSET_MATCH_ANY) == -1) {
+        if (errno == ETIMEDOUT) {
+            return RB_ERROR;
+        }
+    }
+
+    /* Woken, value already changed or interrupted: the caller re-checks */
+    return RB_OK;
+}
+
+static void _ShmFutexWake(volatile uint32_t *addr)
+{
+    syscall(SYS_futex, addr, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+static void _ShmDeadline(struct timespec *deadline, int timeout_ms)
+{
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += timeout_ms / 1000;
+    deadline->tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+static int _ShmValid(RingBufferShm *shm)
+{
+    return shm != nullptr && shm->hdr != nullptr && shm->size > 0;
+}
+
+/*
+ * head and tail live in memory the peer can write: load each once, reject
+ * anything out of range and work on the loaded copies from there on.
+ */
+static int _ShmIndexLoad(RingBufferShm *shm, uint32_t *head, uint32_t *tail)
+{
+    *head = shm->hdr->head;
+    *tail = shm->hdr->tail;
+    if (*head >= shm->size || *tail >= shm->size) {
+        return RB_ERROR_INVALID;
+    }
+
+    return RB_OK;
+}
+
+static uint32_t _ShmLen(RingBufferShm *shm)
+{
+    uint32_t head;
+    uint32_t tail;
+
+    if (_ShmIndexLoad(shm, &head, &tail)) {
+        return 0;
+    }
+
+    return (tail + shm->size - head) % shm->size;
+}
+
+static uint32_t _ShmFree(RingBufferShm *shm)
+{
+    uint32_t head;
+    uint32_t tail;
+
+    if (_ShmIndexLoad(shm, &head, &tail)) {
+        return 0;
+    }
+
+    return shm->size - (tail + shm->size - head) % shm->size - 1;
+}
+
+static void _ShmTailPublish(RingBufferShm *shm, uint32_t tail, uint32_t size)
+{
+    RingBufferShmHeader *hdr = shm->hdr;
+
+    /* Data lands before the index that exposes it */
+    RB_MEMORY_BARRIER();
+    hdr->tail = (tail + size) % shm->size;
+    hdr->totalIn += size;
+
+    /* Pairs with the barrier after the waiter count in RingBufferShmWaitData */
+    RB_MEMORY_BARRIER();
+    if (hdr->dataWaiters) {
+        _ShmFutexWake(&hdr->tail);
+    }
+}
+
+static void _ShmHeadPublish(RingBufferShm *shm, uint32_t head, uint32_t size)
+{
+    RingBufferShmHeader *hdr = shm->hdr;
+
+    /* Reads are done before the space is handed back */
+    RB_MEMORY_BARRIER();
+    hdr->head = (head + size) % shm->size;
+    hdr->totalOut += size;
+
+    RB_MEMORY_BARRIER();
+    if (hdr->spaceWaiters) {
+        _ShmFutexWake(&hdr->head);
+    }
+}
+
+static int _ShmMap(RingBufferShm *shm, int fd, uint64_t mapSize)
+{
+    void *addr;
+
+    addr = mmap(nullptr, (size_t)mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        return RB_ERROR_SYSTEM;
+    }
+
+    shm->hdr = (RingBufferShmHeader *)addr;
+    shm->fd = fd;
+    shm->mapSize = mapSize;
+
+    return RB_OK;
+}
+
+int RingBufferShmCreate(RingBufferShm *shm, const char *name, uint32_t size)
+{
+    RingBufferShmHeader *hdr;
+    uint64_t dataOffset;
+    uint64_t mapSize;
+    long page;
+    int fd;
+    int status;
+
+    if (shm == nullptr || size < 2) {
+        return RB_ERROR_PARAM;
+    }
+    if (name != nullptr && (name[0] != '/' || strlen(name) >= RINGBUFFER_SHM_NAME_MAX)) {
+        return RB_ERROR_PARAM;
+    }
+
+    RB_MEMSET(shm, 0, sizeof(*shm));
+    shm->fd = -1;
+
+    page = sysconf(_SC_PAGESIZE);
+    dataOffset = (sizeof(RingBufferShmHeader) + RINGBUFFER_CACHE_LINE_SIZE - 1) & ~(uint64_t)(RINGBUFFER_CACHE_LINE_SIZE - 1);
+    mapSize = (dataOffset + size + (uint64_t)page - 1) & ~(uint64_t)(page - 1);
+
+    if (name) {
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    } else {
+        fd = memfd_create("ringbuffer", MFD_CLOEXEC);
+    }
+    if (fd < 0) {
+        return RB_ERROR_SYSTEM;
+    }
+    if (ftruncate(fd, (off_t)mapSize) != 0) {
+        status = RB_ERROR_SYSTEM;
+        goto err_fd;
+    }
+
+    status = _ShmMap(shm, fd, mapSize);
+    if (status) {
+        goto err_fd;
+    }
+
+    hdr = shm->hdr;
+    hdr->version = SHM_VERSION;
+    hdr->size = size;
+    hdr->dataOffset = (uint32_t)dataOffset;
+    hdr->mapSize = mapSize;
+    hdr->head = 0;
+    hdr->tail = 0;
+    hdr->totalIn = 0;
+    hdr->totalOut = 0;
+    hdr->dataWaiters = 0;
+    hdr->spaceWaiters = 0;
+
+    /* A peer attaching early sees no magic until the header is complete */
+    RB_MEMORY_BARRIER();
+    hdr->magic = SHM_MAGIC;
+
+    shm->buff = (uint8_t *)hdr + dataOffset;
+    shm->size = size;
+    shm->owner = 1;
+    if (name) {
+        snprintf(shm->name, sizeof(shm->name), "%s", name);
+    }
+
+    return RB_OK;
+
+err_fd:
+    close(fd);
+    if (name) {
+        shm_unlink(name);
+    }
+    RB_MEMSET(shm, 0, sizeof(*shm));
+    shm->fd = -1;
+    return status;
+}
+
+int RingBufferShmAttachFd(RingBufferShm *shm, int fd)
+{
+    RingBufferShmHeader *hdr;
+    struct stat st;
+    int status;
+
+    if (shm == nullptr || fd < 0) {
+        return RB_ERROR_PARAM;
+    }
+
+    RB_MEMSET(shm, 0, sizeof(*shm));
+    shm->fd = -1;
+
+    if (fstat(fd, &st) != 0) {
+        return RB_ERROR_SYSTEM;
+    }
+    if ((uint64_t)st.st_size < sizeof(RingBufferShmHeader)) {
+        return RB_ERROR_INVALID;
+    }
+
+    /* The handle owns its own descriptor, the caller may close theirs */
+    fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (fd < 0) {
+        return RB_ERROR_SYSTEM;
+    }
+
+    status = _ShmMap(shm, fd, (uint64_t)st.st_size);
+    if (status) {
+        close(fd);
+        shm->fd = -1;
+        return status;
+    }
+
+    hdr = shm->hdr;
+    if (hdr->magic != SHM_MAGIC || hdr->version != SHM_VERSION ||
+        hdr->mapSize != (uint64_t)st.st_size || hdr->size < 2 ||
+        (uint64_t)hdr->dataOffset + hdr->size > hdr->mapSize) {
+        RingBufferShmDetach(shm);
+        return RB_ERROR_INVALID;
+    }
+    RB_MEMORY_BARRIER();
+
+    shm->buff = (uint8_t *)hdr + hdr->dataOffset;
+    shm->size = hdr->size;
+
+    return RB_OK;
+}
+
+int RingBufferShmAttach(RingBufferShm *shm, const char *name)
+{
+    int fd;
+    int status;
+
+    if (shm == nullptr || name == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        return RB_ERROR_SYSTEM;
+    }
+
+    status = RingBufferShmAttachFd(shm, fd);
+    close(fd);
+
+    return status;
+}
+
+int RingBufferShmDetach(RingBufferShm *shm)
+{
+    if (shm == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    if (shm->hdr) {
+        munmap(shm->hdr, (size_t)shm->mapSize);
+    }
+    if (shm->fd >= 0) {
+        close(shm->fd);
+    }
+    if (shm->owner && shm->name[0]) {
+        shm_unlink(shm->name);
+    }
+
+    RB_MEMSET(shm, 0, sizeof(*shm));
+    shm->fd = -1;
+
+    return RB_OK;
+}
+
+int RingBufferShmFdGet(RingBufferShm *shm)
+{
+    if (!_ShmValid(shm)) {
+        return RB_ERROR_PARAM;
+    }
+
+    return shm->fd;
+}
+
+uint32_t RingBufferShmLenGet(RingBufferShm *shm)
+{
+    if (!_ShmValid(shm)) {
+        return 0;
+    }
+
+    return _ShmLen(shm);
+}
+
+uint32_t RingBufferShmSizeGet(RingBufferShm *shm)
+{
+    if (!_ShmValid(shm)) {
+        return 0;
+    }
+
+    return shm->size;
+}
+
+uint64_t RingBufferShmTotalInGet(RingBufferShm *shm)
+{
+    if (!_ShmValid(shm)) {
+        return 0;
+    }
+
+    return shm->hdr->totalIn;
+}
+
+uint64_t RingBufferShmTotalOutGet(RingBufferShm *shm)
+{
+    if (!_ShmValid(shm)) {
+        return 0;
+    }
+
+    return shm->hdr->totalOut;
+}
+
+uint32_t RingBufferShmPut(RingBufferShm *shm, const uint8_t *data, uint32_t size)
+{
+    uint32_t head;
+    uint32_t tail;
+    uint32_t space;
+
+    if (!_ShmValid(shm) || data == nullptr || size <= 0) {
+        return 0;
+    }
+    if (_ShmIndexLoad(shm, &head, &tail)) {
+        return 0;
+    }
+
+    space = shm->size - (tail + shm->size - head) % shm->size - 1;
+    if (size > space) {
+        size = space;
+    }
+    if (size == 0) {
+        return 0;
+    }
+
+    if (tail + size <= shm->size) {
+        RB_MEMCPY(&shm->buff[tail], &data[0], size);
+    } else {
+        RB_MEMCPY(&shm->buff[tail], &data[0], shm->size - tail);
+        RB_MEMCPY(&shm->buff[0], &data[shm->size - tail], size - (shm->size - tail));
+    }
+    _ShmTailPublish(shm, tail, size);
+
+    return size;
+}
+
+uint32_t RingBufferShmGet(RingBufferShm *shm, uint8_t *data, uint32_t size)
+{
+    uint32_t head;
+    uint32_t tail;
+    uint32_t len;
+
+    if (!_ShmValid(shm) || data == nullptr || size <= 0) {
+        return 0;
+    }
+    if (_ShmIndexLoad(shm, &head, &tail)) {
+        return 0;
+    }
+
+    len = (tail + shm->size - head) % shm->size;
+    if (size > len) {
+        size = len;
+    }
+    if (size == 0) {
+        return 0;
+    }
+    RB_MEMORY_BARRIER();
+
+    if (head + size <= shm->size) {
+        RB_MEMCPY(&data[0], &shm->buff[head], size);
+    } else {
+        RB_MEMCPY(&data[0], &shm->buff[head], shm->size - head);
+        RB_MEMCPY(&data[shm->size - head], &shm->buff[0], size - (shm->size - head));
+    }
+    _ShmHeadPublish(shm, head, size);
+
+    return size;
+}
+
+uint32_t RingBufferShmWriteAcquire(RingBufferShm *shm, uint8_t **data)
+{
+    uint32_t head;
+    uint32_t tail;
+    uint32_t space;
+
+    if (!_ShmValid(shm) || data == nullptr) {
+        return 0;
+    }
+    if (_ShmIndexLoad(shm, &head, &tail)) {
+        return 0;
+    }
+
+    space = shm->size - (tail + shm->size - head) % shm->size - 1;
+    if (space > shm->size - tail) {
+        space = shm->size - tail;
+    }
+
+    *data = &shm->buff[tail];
+
+    return space;
+}
+
+int RingBufferShmWriteCommit(RingBufferShm *shm, uint32_t size)
+{
+    uint32_t head;
+    uint32_t tail;
+
+    if (!_ShmValid(shm)) {
+        return RB_ERROR_PARAM;
+    }
+    if (_ShmIndexLoad(shm, &head, &tail)) {
+        return RB_ERROR_INVALID;
+    }
+    if (size > shm->size - (tail + shm->size - head) % shm->size - 1 || tail + size > shm->size) {
+        return RB_ERROR_PARAM;
+    }
+    if (size == 0) {
+        return RB_OK;
+    }
+
+    _ShmTailPublish(shm, tail, size);
+
+    return RB_OK;
+}
+
+uint32_t RingBufferShmReadAcquire(RingBufferShm *shm, const uint8_t **data)
+{
+    uint32_t head;
+    uint32_t tail;
+    uint32_t len;
+
+    if (!_ShmValid(shm) || data == nullptr) {
+        return 0;
+    }
+    if (_ShmIndexLoad(shm, &head, &tail)) {
+        return 0;
+    }
+
+    len = (tail + shm->size - head) % shm->size;
+    if (len > shm->size - head) {
+        len = shm->size - head;
+    }
+    RB_MEMORY_BARRIER();
+
+    *data = &shm->buff[head];
+
+    return len;
+}
+
+int RingBufferShmReadRelease(RingBufferShm *shm, uint32_t size)
+{
+    uint32_t head;
+    uint32_t tail;
+
+    if (!_ShmValid(shm)) {
+        return RB_ERROR_PARAM;
+    }
+    if (_ShmIndexLoad(shm, &head, &tail)) {
+        return RB_ERROR_INVALID;
+    }
+    if (size > (tail + shm->size - head) % shm->size || head + size > shm->size) {
+        return RB_ERROR_PARAM;
+    }
+    if (size == 0) {
+        return RB_OK;
+    }
+
+    _ShmHeadPublish(shm, head, size);
+
+    return RB_OK;
+}
+
+/*
+ * The waiter announces itself in the header, then re-checks before
+ * sleeping; the other side moves its index, then looks at the waiter
+ * count. With a barrier on both sides one of them always sees the other.
+ */
+static int _ShmWait(
+    RingBufferShm *shm,
+    volatile uint32_t *word,
+    volatile uint32_t *waiters,
+    uint32_t (*avail)(RingBufferShm *shm),
+    uint32_t size,
+    int timeout_ms
+)
+{
+    struct timespec deadline;
+    uint32_t val;
+    int status;
+
+    if (timeout_ms > 0) {
+        _ShmDeadline(&deadline, timeout_ms);
+    }
+
+    while (1) {
+        val = *word;
+        if (avail(shm) >= size) {
+            return RB_OK;
+        }
+        if (timeout_ms == 0) {
+            return RB_ERROR;
+        }
+
+        __atomic_add_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+        RB_MEMORY_BARRIER();
+        if (*word != val) {
+            __atomic_sub_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+            continue;
+        }
+        status = _ShmFutexWait(word, val, timeout_ms < 0 ? nullptr : &deadline);
+        __atomic_sub_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+
+        if (status) {
+            return avail(shm) >= size ? RB_OK : RB_ERROR;
+        }
+    }
+}
+
+int RingBufferShmWaitData(RingBufferShm *shm, uint32_t size, int timeout_ms)
+{
+    if (!_ShmValid(shm) || size >= shm->size) {
+        return RB_ERROR_PARAM;
+    }
+
+    return _ShmWait(shm, &shm->hdr->tail, &shm->hdr->dataWaiters, _ShmLen, size ? size : 1, timeout_ms);
+}
+
+int RingBufferShmWaitSpace(RingBufferShm *shm, uint32_t size, int timeout_ms)
+{
+    if (!_ShmValid(shm) || size >= shm->size) {
+        return RB_ERROR_PARAM;
+    }
+
+    return _ShmWait(shm, &shm->hdr->head, &shm->hdr->spaceWaiters, _ShmFree, size ? size : 1, timeout_ms);
+}
+
+#endif  /* RINGBUFFER_USE_SHM && __linux__ */
@@ -0,0 +1,89 @@
+#ifndef __RINGBUFFER_SHM_H__
+#define __RINGBUFFER_SHM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "RingBuffer.h"
+
+#if RINGBUFFER_USE_SHM && defined(__linux__)
+
+/*
+ * Ring shared between processes.
+ *
+ * Header and data live in one shared memory object and the header holds
+ * only offsets, so every process may map it at a different address. The
+ * creator names the object (shm_open) or leaves it anonymous (memfd, hand
+ * the fd over with fork or SCM_RIGHTS); the peer joins with
+ * RingBufferShmAttach() or RingBufferShmAttachFd().
+ *
+ * One producer process and one consumer process. The Acquire/Commit and
+ * Acquire/Release pairs give direct access to the shared data without a
+ * copy, the Wait calls block on a futex in the header until the other side
+ * moves its index.
+ */
+
+#define RINGBUFFER_SHM_NAME_MAX         64
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;
+    uint32_t dataOffset;                // From the start of the mapping
+    uint64_t mapSize;
+
+    /* Producer line */
+    RB_ALIGNED(RINGBUFFER_CACHE_LINE_SIZE) volatile uint32_t tail;
+    volatile uint32_t dataWaiters;
+    volatile uint64_t totalIn;
+
+    /* Consumer line */
+    RB_ALIGNED(RINGBUFFER_CACHE_LINE_SIZE) volatile uint32_t head;
+    volatile uint32_t spaceWaiters;
+    volatile uint64_t totalOut;
+} RingBufferShmHeader;
+
+/* Process-local handle, never placed in the shared object */
+typedef struct {
+    RingBufferShmHeader *hdr;
+    uint8_t *buff;
+    uint32_t size;
+
+    int fd;
+    uint64_t mapSize;
+    int owner;
+    char name[RINGBUFFER_SHM_NAME_MAX];
+} RingBufferShm;
+
+int RingBufferShmCreate(RingBufferShm *shm, const char *name, uint32_t size);  // name nullptr for memfd
+int RingBufferShmAttach(RingBufferShm *shm, const char *name);
+int RingBufferShmAttachFd(RingBufferShm *shm, int fd);
+int RingBufferShmDetach(RingBufferShm *shm);    // The creator also unlinks the name
+int RingBufferShmFdGet(RingBufferShm *shm);
+
+uint32_t RingBufferShmLenGet(RingBufferShm *shm);
+uint32_t RingBufferShmSizeGet(RingBufferShm *shm);
+uint64_t RingBufferShmTotalInGet(RingBufferShm *shm);
+uint64_t RingBufferShmTotalOutGet(RingBufferShm *shm);
+
+uint32_t RingBufferShmPut(RingBufferShm *shm, const uint8_t *data, uint32_t size);
+uint32_t RingBufferShmGet(RingBufferShm *shm, uint8_t *data, uint32_t size);
+
+/* Zero copy: contiguous region up to the right border, then commit/release what was used */
+uint32_t RingBufferShmWriteAcquire(RingBufferShm *shm, uint8_t **data);
+int RingBufferShmWriteCommit(RingBufferShm *shm, uint32_t size);
+uint32_t RingBufferShmReadAcquire(RingBufferShm *shm, const uint8_t **data);
+int RingBufferShmReadRelease(RingBufferShm *shm, uint32_t size);
+
+/* Block until `size` bytes are readable / writable, RB_ERROR on timeout, timeout_ms < 0 waits forever */
+int RingBufferShmWaitData(RingBufferShm *shm, uint32_t size, int timeout_ms);
+int RingBufferShmWaitSpace(RingBufferShm *shm, uint32_t size, int timeout_ms);
+
+#endif  /* RINGBUFFER_USE_SHM && __linux__ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__RINGBUFFER_SHM_H__
@@ -0,0 +1,440 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "RingBufferSoftDMA.h"
+
+#if RINGBUFFER_USE_DMA_MODE && RINGBUFFER_USE_SOFT_DMA && defined(__linux__)
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#ifndef nullptr
+#ifdef NULL
+#define nullptr NULL
+#else
+#define nullptr ((void *)0)
+#endif
+#endif
+
+#define SOFT_DMA_DEFAULT_BURST          (4 * 1024)
+
+typedef struct {
+    RingBuffer *rb;
+    RINGBUFFER_SOFT_DMA_DONE Done;
+
+    uint64_t bandwidth;
+    uint32_t burst;
+    volatile uint32_t irqDelayNs;
+    volatile uint32_t circular;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t kick;
+    pthread_cond_t idle;
+
+    /* Protected by lock */
+    int exit;
+    int startReq;
+    int busy;
+
+    volatile int stopReq;
+
+    /* Configured blocks, run back to back once started */
+    RingBufferDMADesc fifo[RINGBUFFER_DMA_QUEUE_DEPTH];
+    uint32_t fifoIn;
+    uint32_t fifoOut;
+
+    volatile uint32_t recvedLen;
+} SoftDMAEngine;
+
+static void _SoftDMAThrottle(SoftDMAEngine *engine, const struct timespec *start, uint64_t done)
+{
+    struct timespec until;
+    uint64_t ns;
+
+    if (engine->bandwidth == 0) {
+        return;
+    }
+
+    ns = done * 1000000000ULL / engine->bandwidth;
+    until.tv_sec = start->tv_sec + (time_t)(ns / 1000000000ULL);
+    until.tv_nsec = start->tv_nsec + (long)(ns % 1000000000ULL);
+    if (until.tv_nsec >= 1000000000L) {
+        until.tv_sec++;
+        until.tv_nsec -= 1000000000L;
+    }
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, nullptr) != 0) {
+        /* Interrupted, sleep again */
+    }
+}
+
+static void _SoftDMADelay(uint32_t ns)
+{
+    struct timespec delay;
+
+    if (ns == 0) {
+        return;
+    }
+
+    delay.tv_sec = (time_t)(ns / 1000000000U);
+    delay.tv_nsec = (long)(ns % 1000000000U);
+    while (nanosleep(&delay, &delay) != 0) {
+        /* Interrupted, sleep the rest */
+    }
+}
+
+/* Raises an irq once the ring is BUSY, like one that fires before the start call has returned */
+static void _SoftDMAIrq(SoftDMAEngine *engine, int half)
+{
+    while (engine->rb->dmaState != RINGBUFFER_DMA_BUSY && !engine->stopReq) {
+        sched_yield();
+    }
+    if (engine->stopReq) {
+        return;
+    }
+
+#if RINGBUFFER_USE_DMA_CIRCULAR
+    if (half) {
+        RingBufferDMAHalfComplete(engine->rb);
+        return;
+    }
+#else
+    (void)half;
+#endif  /* RINGBUFFER_USE_DMA_CIRCULAR */
+
+    RingBufferDMAComplete(engine->rb);
+    if (engine->Done) {
+        engine->Done(engine->rb);
+    }
+}
+
+static uint32_t _SoftDMACopy(SoftDMAEngine *engine, const RingBufferDMADesc *desc)
+{
+    struct timespec start;
+    uint8_t *src = (uint8_t *)(uintptr_t)desc->src;
+    uint8_t *det = (uint8_t *)(uintptr_t)desc->det;
+    uint32_t done;
+    uint32_t n;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (done = 0; done < desc->size && !engine->stopReq; done += n) {
+        n = desc->size - done;
+        if (n > engine->burst) {
+            n = engine->burst;
+        }
+        RB_MEMCPY(&det[done], &src[done], n);
+        __atomic_store_n(&engine->recvedLen, done + n, __ATOMIC_RELEASE);
+        _SoftDMAThrottle(engine, &start, (uint64_t)done + n);
+    }
+
+    return done;
+}
+
+static uint64_t _SoftDMANowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * Circular mode: laps over the block until stopped. HT is raised when the
+ * write position passes the half and TC when it wraps, each irq latency
+ * later while the engine keeps writing; a pending one fires before the next.
+ */
+static void _SoftDMACircular(SoftDMAEngine *engine, const RingBufferDMADesc *desc)
+{
+    struct timespec start;
+    uint8_t *src = (uint8_t *)(uintptr_t)desc->src;
+    uint8_t *det = (uint8_t *)(uintptr_t)desc->det;
+    uint32_t half = desc->size / 2;
+    uint64_t done = 0;
+    uint64_t due = 0;
+    uint32_t pos = 0;
+    int pending = -1;                   // 1 HT, 0 TC, -1 none
+    uint32_t n;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (!engine->stopReq) {
+        n = desc->size - pos;
+        if (n > engine->burst) {
+            n = engine->burst;
+        }
+        if (pos < half && n > half - pos) {
+            n = half - pos;
+        }
+        RB_MEMCPY(&det[pos], &src[pos], n);
+        pos = (pos + n) % desc->size;
+        done += n;
+        __atomic_store_n(&engine->recvedLen, pos, __ATOMIC_RELEASE);
+
+        if (pos == half || pos == 0) {
+            if (pending >= 0) {
+                _SoftDMAIrq(engine, pending);
+            }
+            pending = (pos == half);
+            due = _SoftDMANowNs() + engine->irqDelayNs;
+        }
+        if (pending >= 0 && _SoftDMANowNs() >= due) {
+            _SoftDMAIrq(engine, pending);
+            pending = -1;
+        }
+
+        _SoftDMAThrottle(engine, &start, done);
+    }
+}
+
+static void *_SoftDMAThread(void *arg)
+{
+    SoftDMAEngine *engine = (SoftDMAEngine *)arg;
+    RingBufferDMADesc desc;
+    uint32_t done;
+
+    pthread_mutex_lock(&engine->lock);
+    while (1) {
+        while (!engine->exit && !engine->startReq) {
+            pthread_cond_wait(&engine->kick, &engine->lock);
+        }
+        if (engine->exit) {
+            break;
+        }
+
+        engine->startReq = 0;
+        engine->stopReq = 0;
+
+        while (engine->fifoIn != engine->fifoOut && !engine->stopReq) {
+            desc = engine->fifo[engine->fifoOut++ % RINGBUFFER_DMA_QUEUE_DEPTH];
+            engine->busy = 1;
+            pthread_mutex_unlock(&engine->lock);
+
+            if (engine->circular) {
+                _SoftDMACircular(engine, &desc);
+                pthread_mutex_lock(&engine->lock);
+                break;
+            }
+
+            done = _SoftDMACopy(engine, &desc);
+
+            pthread_mutex_lock(&engine->lock);
+            if (done != desc.size || engine->stopReq) {
+                break;
+            }
+
+            /* Chain into the next queued block before raising the irq */
+            engine->busy = (engine->fifoIn != engine->fifoOut);
+            if (engine->busy) {
+                __atomic_store_n(&engine->recvedLen, 0, __ATOMIC_RELEASE);
+            }
+            pthread_mutex_unlock(&engine->lock);
+
+            /* Irq latency: the engine has chained on, Complete has not run yet */
+            _SoftDMADelay(engine->irqDelayNs);
+            _SoftDMAIrq(engine, 0);
+
+            pthread_mutex_lock(&engine->lock);
+            /* A block linked while we were completing runs on if the ring chained it */
+            if (!engine->busy && engine->rb->dmaState != RINGBUFFER_DMA_BUSY) {
+                break;
+            }
+            engine->startReq = 0;
+        }
+
+        engine->busy = 0;
+        pthread_cond_broadcast(&engine->idle);
+    }
+    pthread_mutex_unlock(&engine->lock);
+
+    return nullptr;
+}
+
+static int _SoftDMAConfig(void *ctx, RB_ADDRESS src, RB_ADDRESS det, uint32_t size)
+{
+    SoftDMAEngine *engine = (SoftDMAEngine *)ctx;
+    RingBufferDMADesc *desc;
+
+    pthread_mutex_lock(&engine->lock);
+    if (engine->fifoIn - engine->fifoOut >= RINGBUFFER_DMA_QUEUE_DEPTH) {
+        pthread_mutex_unlock(&engine->lock);
+        return RB_ERROR_LOCKED;
+    }
+    desc = &engine->fifo[engine->fifoIn++ % RINGBUFFER_DMA_QUEUE_DEPTH];
+    desc->src = src;
+    desc->det = det;
+    desc->size = size;
+    if (!engine->busy) {
+        __atomic_store_n(&engine->recvedLen, 0, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&engine->lock);
+
+    return RB_OK;
+}
+
+static int _SoftDMAStart(void *ctx)
+{
+    SoftDMAEngine *engine = (SoftDMAEngine *)ctx;
+
+    pthread_mutex_lock(&engine->lock);
+    if (engine->busy) {
+        /* Already running, the block was chained */
+        pthread_mutex_unlock(&engine->lock);
+        return RB_OK;
+    }
+    engine->startReq = 1;
+    pthread_cond_signal(&engine->kick);
+    pthread_mutex_unlock(&engine->lock);
+
+    return RB_OK;
+}
+
+static int _SoftDMAStop(void *ctx)
+{
+    SoftDMAEngine *engine = (SoftDMAEngine *)ctx;
+
+    pthread_mutex_lock(&engine->lock);
+    engine->stopReq = 1;
+    engine->startReq = 0;
+    engine->fifoOut = engine->fifoIn;
+    /* Called from Done on the engine thread itself, it stops after returning */
+    while (engine->busy && !pthread_equal(pthread_self(), engine->thread)) {
+        pthread_cond_wait(&engine->idle, &engine->lock);
+    }
+    pthread_mutex_unlock(&engine->lock);
+
+    return RB_OK;
+}
+
+static uint32_t _SoftDMARecvedLen(void *ctx)
+{
+    SoftDMAEngine *engine = (SoftDMAEngine *)ctx;
+
+    return __atomic_load_n(&engine->recvedLen, __ATOMIC_ACQUIRE);
+}
+
+static const RingBufferDMAOps g_softDMAOps = {
+    .DmaConfig = _SoftDMAConfig,
+    .DmaStart = _SoftDMAStart,
+    .DmaStop = _SoftDMAStop,
+    .DmaRecvedLen = _SoftDMARecvedLen,
+    .CleanCache = nullptr,
+    .InvalidCache = nullptr,
+};
+
+int RingBufferSoftDMACreate(RingBuffer *rb, uint64_t bandwidth, uint32_t burst, RINGBUFFER_SOFT_DMA_DONE Done)
+{
+    SoftDMAEngine *engine;
+    int status;
+
+    if (rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->dmaOps == &g_softDMAOps) {
+        return RB_ERROR_LOCKED;
+    }
+
+    engine = (SoftDMAEngine *)RB_MALLOC(sizeof(*engine));
+    if (engine == nullptr) {
+        return RB_ERROR_MEMORY;
+    }
+    RB_MEMSET(engine, 0, sizeof(*engine));
+    engine->rb = rb;
+    engine->Done = Done;
+    engine->bandwidth = bandwidth;
+    engine->burst = burst ? burst : SOFT_DMA_DEFAULT_BURST;
+
+    pthread_mutex_init(&engine->lock, nullptr);
+    pthread_cond_init(&engine->kick, nullptr);
+    pthread_cond_init(&engine->idle, nullptr);
+
+    if (pthread_create(&engine->thread, nullptr, _SoftDMAThread, engine) != 0) {
+        status = RB_ERROR_SYSTEM;
+        goto err_thread;
+    }
+
+    status = RingBufferDMADeviceRegisterEx(rb, &g_softDMAOps, engine);
+    if (status) {
+        goto err_register;
+    }
+
+    return RB_OK;
+
+err_register:
+    pthread_mutex_lock(&engine->lock);
+    engine->exit = 1;
+    pthread_cond_signal(&engine->kick);
+    pthread_mutex_unlock(&engine->lock);
+    pthread_join(engine->thread, nullptr);
+err_thread:
+    pthread_cond_destroy(&engine->idle);
+    pthread_cond_destroy(&engine->kick);
+    pthread_mutex_destroy(&engine->lock);
+    RB_FREE(engine);
+    return status;
+}
+
+int RingBufferSoftDMAIrqDelaySet(RingBuffer *rb, uint32_t ns)
+{
+    SoftDMAEngine *engine;
+
+    if (rb == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->dmaOps != &g_softDMAOps) {
+        return RB_ERROR_INVALID;
+    }
+    engine = (SoftDMAEngine *)rb->dmaCtx;
+    engine->irqDelayNs = ns;
+
+    return RB_OK;
+}
+
+int RingBufferSoftDMACircularSet(RingBuffer *rb, uint32_t enable)
+{
+    SoftDMAEngine *engine;
+
+    if (rb == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->dmaOps != &g_softDMAOps) {
+        return RB_ERROR_INVALID;
+    }
+    engine = (SoftDMAEngine *)rb->dmaCtx;
+    engine->circular = enable ? 1 : 0;
+
+    return RB_OK;
+}
+
+int RingBufferSoftDMADelete(RingBuffer *rb)
+{
+    SoftDMAEngine *engine;
+
+    if (rb == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->dmaOps != &g_softDMAOps) {
+        return RB_ERROR_INVALID;
+    }
+    engine = (SoftDMAEngine *)rb->dmaCtx;
+
+    RingBufferDMADeviceUnregister(rb);
+
+    pthread_mutex_lock(&engine->lock);
+    engine->stopReq = 1;
+    engine->exit = 1;
+    pthread_cond_signal(&engine->kick);
+    pthread_mutex_unlock(&engine->lock);
+    pthread_join(engine->thread, nullptr);
+
+    pthread_cond_destroy(&engine->idle);
+    pthread_cond_destroy(&engine->kick);
+    pthread_mutex_destroy(&engine->lock);
+
+    RB_FREE(engine);
+
+    return RB_OK;
+}
+
+#endif  /* RINGBUFFER_USE_DMA_MODE && RINGBUFFER_USE_SOFT_DMA && __linux__ */
@@ -0,0 +1,55 @@
+#ifndef __RINGBUFFER_SOFT_DMA_H__
+#define __RINGBUFFER_SOFT_DMA_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "RingBuffer.h"
+
+#if RINGBUFFER_USE_DMA_MODE && RINGBUFFER_USE_SOFT_DMA && defined(__linux__)
+
+/*
+ * Emulated dma engine for hosts without one.
+ *
+ * A worker thread plays the part of the dma controller: after
+ * RingBufferDMAStart() it copies the configured block in bursts of
+ * `burst` bytes, throttled to `bandwidth` bytes per second (0 means as
+ * fast as memcpy allows), and publishes the received length after every
+ * burst so RingBufferLenGet() sees data arrive progressively. At the end
+ * of the block it calls RingBufferDMAComplete() the way an irq handler
+ * would, then `Done` if given. `Done` runs on the engine thread and may
+ * configure and start the next block.
+ *
+ * Each ring gets its own engine and thread, registered through the
+ * context flavour of the dma callbacks.
+ */
+
+typedef void (*RINGBUFFER_SOFT_DMA_DONE)(RingBuffer *rb);
+
+int RingBufferSoftDMACreate(RingBuffer *rb, uint64_t bandwidth, uint32_t burst, RINGBUFFER_SOFT_DMA_DONE Done);
+int RingBufferSoftDMADelete(RingBuffer *rb);
+
+/*
+ * Emulated irq latency: the engine chains into the next queued block
+ * (DmaRecvedLen restarts at 0) and only calls RingBufferDMAComplete()
+ * `ns` nanoseconds later. 0, the default, raises it right away.
+ */
+int RingBufferSoftDMAIrqDelaySet(RingBuffer *rb, uint32_t ns);
+
+/*
+ * Circular mode, set before RingBufferDMACircularStart(): the engine laps
+ * over the block until stopped, reading the source again every lap, and
+ * raises RingBufferDMAHalfComplete() and RingBufferDMAComplete() when it
+ * passes the half and the end of each lap, the irq delay later while it
+ * keeps writing. `Done` is called after the latter.
+ */
+int RingBufferSoftDMACircularSet(RingBuffer *rb, uint32_t enable);
+
+#endif  /* RINGBUFFER_USE_DMA_MODE && RINGBUFFER_USE_SOFT_DMA && __linux__ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__RINGBUFFER_SOFT_DMA_H__
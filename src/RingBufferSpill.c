@@ -0,0 +1,295 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "RingBufferSpill.h"
+
+#if RINGBUFFER_USE_SPILL && defined(__linux__)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#ifndef nullptr
+#ifdef NULL
+#define nullptr NULL
+#else
+#define nullptr ((void *)0)
+#endif
+#endif
+
+static void _SpillPath(RingBufferSpill *sp, uint32_t seq, char *path, size_t len)
+{
+    snprintf(path, len, "%s.%08u.seg", sp->prefix, seq);
+}
+
+static uint64_t _SpillDiskLen(RingBufferSpill *sp)
+{
+    uint64_t len = sp->spilledIn - sp->spilledOut;
+
+    RB_MEMORY_BARRIER();
+    return len;
+}
+
+static uint32_t _SpillWrite(RingBufferSpill *sp, const uint8_t *data, uint32_t size)
+{
+    char path[RINGBUFFER_SPILL_PATH_MAX + 16];
+    uint32_t done = 0;
+    uint32_t chunk;
+    ssize_t n;
+
+    while (done < size) {
+        if (sp->writeFd < 0) {
+            _SpillPath(sp, sp->writeSeq, path, sizeof(path));
+            sp->writeFd = open(path, O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, 0600);
+            if (sp->writeFd < 0) {
+                break;
+            }
+        }
+
+        chunk = size - done;
+        if (chunk > sp->segmentSize - sp->writeOff) {
+            chunk = sp->segmentSize - sp->writeOff;
+        }
+
+        n = write(sp->writeFd, &data[done], chunk);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        done += (uint32_t)n;
+        sp->writeOff += (uint32_t)n;
+
+        /* The bytes are in the page cache before the consumer may read them */
+        RB_MEMORY_BARRIER();
+        sp->spilledIn += (uint64_t)n;
+
+        if (sp->writeOff == sp->segmentSize) {
+            close(sp->writeFd);
+            sp->writeFd = -1;
+            sp->writeSeq++;
+            sp->writeOff = 0;
+        }
+    }
+
+    return done;
+}
+
+static uint32_t _SpillRead(RingBufferSpill *sp, uint8_t *data, uint32_t size)
+{
+    char path[RINGBUFFER_SPILL_PATH_MAX + 16];
+    uint32_t done = 0;
+    uint32_t chunk;
+    ssize_t n;
+
+    while (done < size) {
+        if (sp->readFd < 0) {
+            _SpillPath(sp, sp->readSeq, path, sizeof(path));
+            sp->readFd = open(path, O_RDONLY | O_CLOEXEC);
+            if (sp->readFd < 0) {
+                break;
+            }
+        }
+
+        chunk = size - done;
+        if (chunk > sp->segmentSize - sp->readOff) {
+            chunk = sp->segmentSize - sp->readOff;
+        }
+
+        n = read(sp->readFd, &data[done], chunk);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        done += (uint32_t)n;
+        sp->readOff += (uint32_t)n;
+
+        RB_MEMORY_BARRIER();
+        sp->spilledOut += (uint64_t)n;
+
+        /* The producer moved on after filling it, nobody needs it anymore */
+        if (sp->readOff == sp->segmentSize) {
+            close(sp->readFd);
+            sp->readFd = -1;
+            _SpillPath(sp, sp->readSeq, path, sizeof(path));
+            unlink(path);
+            sp->readSeq++;
+            sp->readOff = 0;
+        }
+    }
+
+    return done;
+}
+
+int RingBufferSpillCreate(
+    RingBufferSpill *sp,
+    RingBuffer *rb,
+    const char *prefix,
+    uint32_t threshold,
+    uint32_t segmentSize,
+    uint64_t maxBytes
+)
+{
+    if (sp == nullptr || rb == nullptr || rb->buff == nullptr || rb->size <= 0) {
+        return RB_ERROR_PARAM;
+    }
+    if (prefix == nullptr || strlen(prefix) >= RINGBUFFER_SPILL_PATH_MAX) {
+        return RB_ERROR_PARAM;
+    }
+    if (threshold <= 0 || threshold >= rb->size || segmentSize <= 0) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->mode != RINGBUFFER_CPU_MODE) {
+        return RB_ERROR_INVALID;
+    }
+
+    RB_MEMSET(sp, 0, sizeof(*sp));
+    sp->rb = rb;
+    snprintf(sp->prefix, sizeof(sp->prefix), "%s", prefix);
+    sp->threshold = threshold;
+    sp->segmentSize = segmentSize;
+    sp->maxBytes = maxBytes;
+    sp->writeFd = -1;
+    sp->readFd = -1;
+
+    return RB_OK;
+}
+
+int RingBufferSpillDelete(RingBufferSpill *sp)
+{
+    char path[RINGBUFFER_SPILL_PATH_MAX + 16];
+    uint32_t seq;
+
+    if (sp == nullptr || sp->rb == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    if (sp->writeFd >= 0) {
+        close(sp->writeFd);
+    }
+    if (sp->readFd >= 0) {
+        close(sp->readFd);
+    }
+    for (seq = sp->readSeq; seq != sp->writeSeq + 1; seq++) {
+        _SpillPath(sp, seq, path, sizeof(path));
+        unlink(path);
+    }
+
+    RB_MEMSET(sp, 0, sizeof(*sp));
+    sp->writeFd = -1;
+    sp->readFd = -1;
+
+    return RB_OK;
+}
+
+uint32_t RingBufferSpillPut(RingBufferSpill *sp, uint8_t *data, uint32_t size)
+{
+    uint32_t done = 0;
+    uint32_t len;
+    uint64_t disk;
+    uint64_t room;
+
+    if (sp == nullptr || sp->rb == nullptr || data == nullptr || size <= 0) {
+        return 0;
+    }
+
+    /* The ring only takes data while nothing older waits on disk */
+    disk = _SpillDiskLen(sp);
+    if (disk == 0) {
+        len = RingBufferLenGet(sp->rb);
+        if (len < sp->threshold) {
+            done = RingBufferPut(sp->rb, data, size < sp->threshold - len ? size : sp->threshold - len);
+        }
+        if (done == size) {
+            return done;
+        }
+    }
+
+    size -= done;
+    if (sp->maxBytes) {
+        room = disk < sp->maxBytes ? sp->maxBytes - disk : 0;
+        if (size > room) {
+            sp->droppedBytes += size - room;
+            size = (uint32_t)room;
+        }
+    }
+    if (size) {
+        len = _SpillWrite(sp, &data[done], size);
+        sp->droppedBytes += size - len;
+        done += len;
+    }
+
+    return done;
+}
+
+uint32_t RingBufferSpillGet(RingBufferSpill *sp, uint8_t *data, uint32_t size)
+{
+    uint32_t done = 0;
+    uint32_t len;
+    uint64_t disk;
+
+    if (sp == nullptr || sp->rb == nullptr || data == nullptr || size <= 0) {
+        return 0;
+    }
+
+    while (done < size) {
+        done += RingBufferGet(sp->rb, &data[done], size - done);
+        if (done == size) {
+            break;
+        }
+
+        disk = _SpillDiskLen(sp);
+        if (disk == 0) {
+            break;
+        }
+        /*
+         * A put may have split between the ring and the disk after the
+         * ring looked empty; the ring part is older and comes first.
+         */
+        if (RingBufferLenGet(sp->rb)) {
+            continue;
+        }
+
+        len = _SpillRead(sp, &data[done], size - done < disk ? size - done : (uint32_t)disk);
+        if (len == 0) {
+            break;
+        }
+        done += len;
+    }
+
+    return done;
+}
+
+uint64_t RingBufferSpillLenGet(RingBufferSpill *sp)
+{
+    if (sp == nullptr || sp->rb == nullptr) {
+        return 0;
+    }
+
+    return RingBufferLenGet(sp->rb) + _SpillDiskLen(sp);
+}
+
+uint64_t RingBufferSpillDiskLenGet(RingBufferSpill *sp)
+{
+    if (sp == nullptr || sp->rb == nullptr) {
+        return 0;
+    }
+
+    return _SpillDiskLen(sp);
+}
+
+uint64_t RingBufferSpillDroppedGet(RingBufferSpill *sp)
+{
+    if (sp == nullptr || sp->rb == nullptr) {
+        return 0;
+    }
+
+    return sp->droppedBytes;
+}
+
+#endif  /* RINGBUFFER_USE_SPILL && __linux__ */
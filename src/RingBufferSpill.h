@@ -0,0 +1,73 @@
+#ifndef __RINGBUFFER_SPILL_H__
+#define __RINGBUFFER_SPILL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "RingBuffer.h"
+
+#if RINGBUFFER_USE_SPILL && defined(__linux__)
+
+/*
+ * Overflow tier on disk for a cpu mode ring.
+ *
+ * RingBufferSpillPut() fills the ring up to `threshold` bytes and appends
+ * the rest sequentially to segment files named "<prefix>.<seq>.seg", each
+ * at most `segmentSize` bytes. While anything is on disk further puts go
+ * there too, so the ring always holds the oldest data. RingBufferSpillGet()
+ * drains the ring, then reads the segments back in order and deletes each
+ * one once consumed; when the disk is empty puts return to the ring.
+ *
+ * Puts beyond `maxBytes` on disk are dropped (0 for no limit). One
+ * producer and one consumer thread.
+ */
+
+#define RINGBUFFER_SPILL_PATH_MAX       256
+
+typedef struct {
+    RingBuffer *rb;
+    char prefix[RINGBUFFER_SPILL_PATH_MAX];
+
+    uint32_t threshold;
+    uint32_t segmentSize;
+    uint64_t maxBytes;
+
+    /* Producer side */
+    int writeFd;
+    uint32_t writeSeq;
+    uint32_t writeOff;
+    volatile uint64_t spilledIn;        // Bytes appended to disk
+    uint64_t droppedBytes;
+
+    /* Consumer side */
+    int readFd;
+    uint32_t readSeq;
+    uint32_t readOff;
+    volatile uint64_t spilledOut;       // Bytes read back from disk
+} RingBufferSpill;
+
+int RingBufferSpillCreate(
+    RingBufferSpill *sp,
+    RingBuffer *rb,
+    const char *prefix,
+    uint32_t threshold,
+    uint32_t segmentSize,
+    uint64_t maxBytes
+);
+int RingBufferSpillDelete(RingBufferSpill *sp);     // Removes the remaining segments
+
+uint32_t RingBufferSpillPut(RingBufferSpill *sp, uint8_t *data, uint32_t size);
+uint32_t RingBufferSpillGet(RingBufferSpill *sp, uint8_t *data, uint32_t size);
+
+uint64_t RingBufferSpillLenGet(RingBufferSpill *sp);        // Ring plus disk
+uint64_t RingBufferSpillDiskLenGet(RingBufferSpill *sp);
+uint64_t RingBufferSpillDroppedGet(RingBufferSpill *sp);
+
+#endif  /* RINGBUFFER_USE_SPILL && __linux__ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__RINGBUFFER_SPILL_H__
@@ -0,0 +1,247 @@
+#include "RingBufferTimed.h"
+
+#if RINGBUFFER_USE_TIMED
+
+#ifndef nullptr
+#ifdef NULL
+#define nullptr NULL
+#else
+#define nullptr ((void *)0)
+#endif
+#endif
+
+static void _TimedCopyOut(RingBuffer *rb, uint32_t off, uint8_t *data, uint32_t size)
+{
+    off %= rb->size;
+    if (off + size <= rb->size) {
+        RB_MEMCPY(&data[0], &rb->buff[off], size);
+    } else {
+        RB_MEMCPY(&data[0], &rb->buff[off], rb->size - off);
+        RB_MEMCPY(&data[rb->size - off], &rb->buff[0], size - (rb->size - off));
+    }
+}
+
+static void _TimedSkip(RingBuffer *rb, uint32_t size)
+{
+    /* Reads of the record are done before the space is handed back */
+    RB_MEMORY_BARRIER();
+    rb->head = (rb->head + size) % rb->size;
+    rb->totalOut += size;
+}
+
+int RingBufferTimedCreate(RingBufferTimed *rt, RingBuffer *rb)
+{
+    if (rt == nullptr || rb == nullptr || rb->buff == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->size <= RINGBUFFER_TIMED_HEADER_SIZE + 1) {
+        return RB_ERROR_PARAM;
+    }
+    if (rb->mode != RINGBUFFER_CPU_MODE) {
+        return RB_ERROR_INVALID;
+    }
+
+    RB_MEMSET(rt, 0, sizeof(*rt));
+    rt->rb = rb;
+    rt->stride = (rb->size + RINGBUFFER_TIMED_INDEX_SIZE - 1) / RINGBUFFER_TIMED_INDEX_SIZE;
+
+    return RB_OK;
+}
+
+int RingBufferTimedDelete(RingBufferTimed *rt)
+{
+    if (rt == nullptr || rt->rb == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+
+    RB_MEMSET(rt, 0, sizeof(*rt));
+
+    return RB_OK;
+}
+
+int RingBufferTimedPut(RingBufferTimed *rt, uint64_t ts, uint8_t *data, uint32_t size)
+{
+    uint8_t hdr[RINGBUFFER_TIMED_HEADER_SIZE];
+    RingBufferTimedIndex *entry;
+    RingBuffer *rb;
+    uint64_t pos;
+
+    if (rt == nullptr || rt->rb == nullptr || data == nullptr || size <= 0) {
+        return RB_ERROR_PARAM;
+    }
+    rb = rt->rb;
+
+    if (ts < rt->lastTs || size > rb->size - 1 - RINGBUFFER_TIMED_HEADER_SIZE) {
+        return RB_ERROR_PARAM;
+    }
+    /* Only the consumer frees space, what fits now still fits below */
+    if (RINGBUFFER_TIMED_HEADER_SIZE + size > RingBufferSpaceGet(rb)) {
+        return RB_ERROR_LOCKED;
+    }
+
+    pos = rb->totalIn;
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+    /* Put bytes not published yet sit in front of the record */
+    pos += rb->pendLen;
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+    RB_MEMCPY(&hdr[0], &size, sizeof(size));
+    RB_MEMCPY(&hdr[sizeof(size)], &ts, sizeof(ts));
+
+    /* The consumer waits until the whole record is behind the tail */
+    RingBufferPut(rb, hdr, RINGBUFFER_TIMED_HEADER_SIZE);
+    RingBufferPut(rb, data, size);
+    rt->lastTs = ts;
+
+    if (rt->indexIn == 0 || pos - rt->lastIndexed >= rt->stride) {
+        entry = &rt->index[rt->indexIn % RINGBUFFER_TIMED_INDEX_SIZE];
+        entry->ts = ts;
+        entry->pos = pos;
+        rt->lastIndexed = pos;
+
+        RB_MEMORY_BARRIER();
+        rt->indexIn++;
+    }
+
+    return RB_OK;
+}
+
+int RingBufferTimedPeek(RingBufferTimed *rt, uint64_t *ts, uint32_t *size)
+{
+    uint8_t hdr[RINGBUFFER_TIMED_HEADER_SIZE];
+    RingBuffer *rb;
+    uint32_t len;
+    uint32_t recLen;
+
+    if (rt == nullptr || rt->rb == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+    rb = rt->rb;
+
+    len = RingBufferLenGet(rb);
+    if (len < RINGBUFFER_TIMED_HEADER_SIZE) {
+        return RB_ERROR_LOCKED;
+    }
+
+    RB_MEMORY_BARRIER();
+    _TimedCopyOut(rb, rb->head, hdr, RINGBUFFER_TIMED_HEADER_SIZE);
+    RB_MEMCPY(&recLen, &hdr[0], sizeof(recLen));
+    if (len - RINGBUFFER_TIMED_HEADER_SIZE < recLen) {
+        return RB_ERROR_LOCKED;
+    }
+
+    if (ts) {
+        RB_MEMCPY(ts, &hdr[sizeof(recLen)], sizeof(*ts));
+    }
+    if (size) {
+        *size = recLen;
+    }
+
+    return RB_OK;
+}
+
+uint32_t RingBufferTimedGet(RingBufferTimed *rt, uint64_t *ts, uint8_t *data, uint32_t size)
+{
+    RingBuffer *rb;
+    uint32_t recLen;
+
+    if (rt == nullptr || rt->rb == nullptr || (data == nullptr && size > 0)) {
+        return 0;
+    }
+    if (RingBufferTimedPeek(rt, ts, &recLen) != RB_OK) {
+        return 0;
+    }
+    rb = rt->rb;
+
+    if (size > recLen) {
+        size = recLen;
+    }
+    if (size) {
+        _TimedCopyOut(rb, rb->head + RINGBUFFER_TIMED_HEADER_SIZE, data, size);
+    }
+    _TimedSkip(rb, RINGBUFFER_TIMED_HEADER_SIZE + recLen);
+
+    return recLen;
+}
+
+/* Latest indexed position whose record is older than ts, or totalOut */
+static uint64_t _TimedIndexFind(RingBufferTimed *rt, uint64_t ts)
+{
+    RingBufferTimedIndex *index = rt->index;
+    uint64_t out = rt->rb->totalOut;
+    uint64_t pos = out;
+    uint32_t in;
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t mid;
+
+    in = rt->indexIn;
+    RB_MEMORY_BARRIER();
+
+    /* The oldest slot is the next one the producer overwrites */
+    lo = in > RINGBUFFER_TIMED_INDEX_SIZE - 1 ? in - (RINGBUFFER_TIMED_INDEX_SIZE - 1) : 0;
+    hi = in;
+
+    /* Skip entries the consumer has already passed */
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (index[mid % RINGBUFFER_TIMED_INDEX_SIZE].pos < out) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    /* First of the remaining entries at or after ts */
+    hi = in;
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (index[mid % RINGBUFFER_TIMED_INDEX_SIZE].ts < ts) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo > 0 && index[(lo - 1) % RINGBUFFER_TIMED_INDEX_SIZE].pos >= out) {
+        pos = index[(lo - 1) % RINGBUFFER_TIMED_INDEX_SIZE].pos;
+    }
+
+    /* The slot may have been reused during the search */
+    RB_MEMORY_BARRIER();
+    if (lo > 0 && rt->indexIn - (lo - 1) >= RINGBUFFER_TIMED_INDEX_SIZE) {
+        pos = out;
+    }
+
+    return pos;
+}
+
+int RingBufferTimedSeek(RingBufferTimed *rt, uint64_t ts)
+{
+    RingBuffer *rb;
+    uint64_t pos;
+    uint64_t recTs;
+    uint32_t recLen;
+
+    if (rt == nullptr || rt->rb == nullptr) {
+        return RB_ERROR_PARAM;
+    }
+    rb = rt->rb;
+
+    /*
+     * On a batched ring an entry may point past the published tail, the
+     * record walk below only ever looks at complete records.
+     */
+    pos = _TimedIndexFind(rt, ts);
+    if (pos > rb->totalOut && pos - rb->totalOut <= RingBufferLenGet(rb)) {
+        _TimedSkip(rb, (uint32_t)(pos - rb->totalOut));
+    }
+
+    /* Normally only one stride of records is left to walk */
+    while (RingBufferTimedPeek(rt, &recTs, &recLen) == RB_OK && recTs < ts) {
+        _TimedSkip(rb, RINGBUFFER_TIMED_HEADER_SIZE + recLen);
+    }
+
+    return RB_OK;
+}
+
+#endif  /* RINGBUFFER_USE_TIMED */
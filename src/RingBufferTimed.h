@@ -0,0 +1,63 @@
+#ifndef __RINGBUFFER_TIMED_H__
+#define __RINGBUFFER_TIMED_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "RingBuffer.h"
+
+#if RINGBUFFER_USE_TIMED
+
+/*
+ * Timestamped record mode over a cpu mode ring.
+ *
+ * Every RingBufferTimedPut() stores one record, a header holding length
+ * and timestamp followed by the payload, or nothing when it does not fit.
+ * Timestamps are caller supplied in any monotonic unit and must not go
+ * backwards.
+ *
+ * Next to the ring a sparse index samples (timestamp, stream position)
+ * about every size / RINGBUFFER_TIMED_INDEX_SIZE bytes. RingBufferTimedSeek()
+ * binary searches it and scans at most one stride of records to drop
+ * everything older than the given time, so the next Get returns the first
+ * record at or after it.
+ */
+
+#define RINGBUFFER_TIMED_HEADER_SIZE    12      // Length (4) + timestamp (8)
+
+typedef struct {
+    volatile uint64_t ts;
+    volatile uint64_t pos;              // rb->totalIn before the record
+} RingBufferTimedIndex;
+
+typedef struct {
+    RingBuffer *rb;
+    uint32_t stride;
+
+    /* Producer side */
+    uint64_t lastTs;
+    uint64_t lastIndexed;
+    volatile uint32_t indexIn;
+    RingBufferTimedIndex index[RINGBUFFER_TIMED_INDEX_SIZE];
+} RingBufferTimed;
+
+int RingBufferTimedCreate(RingBufferTimed *rt, RingBuffer *rb);
+int RingBufferTimedDelete(RingBufferTimed *rt);
+
+int RingBufferTimedPut(RingBufferTimed *rt, uint64_t ts, uint8_t *data, uint32_t size);  // RB_ERROR_LOCKED when full
+
+/* Next complete record without consuming it, RB_ERROR_LOCKED when there is none */
+int RingBufferTimedPeek(RingBufferTimed *rt, uint64_t *ts, uint32_t *size);
+/* Returns the record length, copies at most `size` bytes and drops the rest; 0 when empty */
+uint32_t RingBufferTimedGet(RingBufferTimed *rt, uint64_t *ts, uint8_t *data, uint32_t size);
+
+int RingBufferTimedSeek(RingBufferTimed *rt, uint64_t ts);
+
+#endif  /* RINGBUFFER_USE_TIMED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__RINGBUFFER_TIMED_H__
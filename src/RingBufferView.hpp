@@ -0,0 +1,152 @@
+#ifndef __RINGBUFFER_VIEW_HPP__
+#define __RINGBUFFER_VIEW_HPP__
+
+#include "RingBuffer.h"
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#if __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<span>)
+#include <span>
+#define RINGBUFFER_VIEW_SPAN            1
+#endif
+#endif
+
+/*
+ * Read-only view of the readable region of a cpu mode ring, header only.
+ *
+ * The view snapshots head and length on the consumer side, so the data it
+ * covers stays put while the producer keeps writing behind it. Its
+ * random-access iterators hide the wrap, which lets standard algorithms
+ * (std::find, std::copy, std::accumulate) and parsers run on ring memory
+ * directly; First()/Second() hand out the two contiguous segments, as
+ * std::span from C++20 on. Consume() releases bytes from the front and
+ * narrows the view accordingly.
+ */
+
+class RingBufferView {
+public:
+    class Iterator {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef uint8_t value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const uint8_t *pointer;
+        typedef const uint8_t &reference;
+
+        Iterator() : buff_(nullptr), size_(0), start_(0), pos_(0) {}
+        Iterator(const uint8_t *buff, uint32_t size, uint32_t start, uint32_t pos)
+            : buff_(buff), size_(size), start_(start), pos_(pos) {}
+
+        reference operator*() const
+        {
+            uint32_t off = start_ + pos_;
+
+            return buff_[off >= size_ ? off - size_ : off];
+        }
+        pointer operator->() const { return &**this; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        Iterator &operator++() { pos_++; return *this; }
+        Iterator operator++(int) { Iterator it = *this; pos_++; return it; }
+        Iterator &operator--() { pos_--; return *this; }
+        Iterator operator--(int) { Iterator it = *this; pos_--; return it; }
+        Iterator &operator+=(difference_type n) { pos_ = (uint32_t)((difference_type)pos_ + n); return *this; }
+        Iterator &operator-=(difference_type n) { pos_ = (uint32_t)((difference_type)pos_ - n); return *this; }
+
+        friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+        friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+        friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const Iterator &a, const Iterator &b)
+        {
+            return (difference_type)a.pos_ - (difference_type)b.pos_;
+        }
+
+        friend bool operator==(const Iterator &a, const Iterator &b) { return a.pos_ == b.pos_; }
+        friend bool operator!=(const Iterator &a, const Iterator &b) { return a.pos_ != b.pos_; }
+        friend bool operator<(const Iterator &a, const Iterator &b) { return a.pos_ < b.pos_; }
+        friend bool operator>(const Iterator &a, const Iterator &b) { return a.pos_ > b.pos_; }
+        friend bool operator<=(const Iterator &a, const Iterator &b) { return a.pos_ <= b.pos_; }
+        friend bool operator>=(const Iterator &a, const Iterator &b) { return a.pos_ >= b.pos_; }
+
+    private:
+        const uint8_t *buff_;
+        uint32_t size_;
+        uint32_t start_;                // Ring offset of position 0
+        uint32_t pos_;                  // Position inside the view
+    };
+
+    typedef Iterator iterator;
+    typedef Iterator const_iterator;
+    typedef uint8_t value_type;
+    typedef uint32_t size_type;
+
+    explicit RingBufferView(RingBuffer *rb) : rb_(rb), head_(0), len_(0)
+    {
+        Refresh();
+    }
+
+    /* Takes in what the producer added since the snapshot */
+    void Refresh()
+    {
+        if (rb_ == nullptr || rb_->buff == nullptr || rb_->size <= 0) {
+            return;
+        }
+
+        len_ = RingBufferLenGet(rb_);
+        /* Data behind tail is complete */
+        RB_MEMORY_BARRIER();
+        head_ = rb_->head;
+    }
+
+    uint32_t size() const { return len_; }
+    bool empty() const { return len_ == 0; }
+
+    Iterator begin() const { return Iterator(rb_->buff, rb_->size, head_, 0); }
+    Iterator end() const { return Iterator(rb_->buff, rb_->size, head_, len_); }
+
+    const uint8_t &operator[](uint32_t i) const { return begin()[i]; }
+
+    const uint8_t *FirstData() const { return &rb_->buff[head_]; }
+    uint32_t FirstSize() const { return len_ < rb_->size - head_ ? len_ : rb_->size - head_; }
+    const uint8_t *SecondData() const { return &rb_->buff[0]; }
+    uint32_t SecondSize() const { return len_ - FirstSize(); }
+
+#if RINGBUFFER_VIEW_SPAN
+    std::span<const uint8_t> First() const { return std::span<const uint8_t>(FirstData(), FirstSize()); }
+    std::span<const uint8_t> Second() const { return std::span<const uint8_t>(SecondData(), SecondSize()); }
+#endif
+
+    /* Hands the first `size` bytes back to the producer, the view keeps the rest */
+    uint32_t Consume(uint32_t size)
+    {
+        if (size > len_) {
+            size = len_;
+        }
+        if (size == 0) {
+            return 0;
+        }
+
+        /* Reads through the view are done before the space is reused */
+        RB_MEMORY_BARRIER();
+        head_ = (head_ + size) % rb_->size;
+        rb_->head = head_;
+        rb_->totalOut += size;
+        len_ -= size;
+
+        return size;
+    }
+
+private:
+    RingBuffer *rb_;
+    uint32_t head_;
+    uint32_t len_;
+};
+
+#endif  /* __cplusplus */
+
+#endif  // !__RINGBUFFER_VIEW_HPP__
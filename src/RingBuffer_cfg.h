@@ -3,8 +3,66 @@
 
 #define RINGBUFFER_USE_RX_OVERFLOW        1
 
+#define RINGBUFFER_CACHE_LINE_SIZE        64
+
+/* Runtime statistics */
+#define RINGBUFFER_USE_STATISTICS         1
+
+/* USDT tracepoints, needs <sys/sdt.h> */
+#define RINGBUFFER_USE_TRACE              0
+
+/* Cpu mode puts may publish tail every N bytes, see RingBufferPublishBatchSet */
+#define RINGBUFFER_USE_DEFERRED_PUBLISH   1
+
+/* Argument checks in the inline fast path of RingBufferFast.h, for debug builds */
+#define RINGBUFFER_FAST_CHECK             0
+
+/* Cpu mode ring variant with 64-bit sizes, indexes and lengths, 64-bit hosts only */
+#define RINGBUFFER_USE_64BIT              1
+
+/* Cross-process ring in shared memory, linux only */
+#define RINGBUFFER_USE_SHM                1
+
+/* Persistent ring in a memory-mapped file, linux only */
+#define RINGBUFFER_USE_FILE               1
+
+/* Overflow tier spilling puts to segment files, linux only */
+#define RINGBUFFER_USE_SPILL              1
+
+/* Block compression stage between rings, with the in-tree lz codec */
+#define RINGBUFFER_USE_COMPRESS           1
+
+/* One producer, several readers with their own cursors */
+#define RINGBUFFER_USE_BROADCAST          1
+    #define RINGBUFFER_BROADCAST_READERS  8
+
+/* Timestamped records with a sparse time index */
+#define RINGBUFFER_USE_TIMED              1
+    #define RINGBUFFER_TIMED_INDEX_SIZE   256   /* Index entries spread over the ring */
+
+/* Priority lanes over several rings */
+#define RINGBUFFER_USE_LANES              1
+    #define RINGBUFFER_LANES_MAX          8
+
+/* eventfd wakeups for epoll loops, Linux only */
+#define RINGBUFFER_USE_EVENTFD            1
+
+/* Stage pipeline over chained rings on worker threads, Linux only */
+#define RINGBUFFER_USE_PIPELINE           1
+    #define RINGBUFFER_PIPELINE_STAGES    8
+
+/* Per-core sharded rings with one aggregating consumer, Linux only */
+#define RINGBUFFER_USE_SHARD              1
+    #define RINGBUFFER_SHARD_MAX          64
+
 /* DMA mode */
 #define RINGBUFFER_USE_DMA_MODE           1
     #define RINGBUFFER_USE_LATEST_LEN     1
+    #define RINGBUFFER_USE_SOFT_DMA       1     /* Emulated dma engine, linux only */
+    #define RINGBUFFER_DMA_QUEUE_DEPTH    2     /* Blocks queued ahead with RingBufferDMAEnqueue */
+    #define RINGBUFFER_USE_DMA_CIRCULAR   1     /* Hardware circular mode over the whole buffer */
+    #define RINGBUFFER_DMA_TX_MAX_BLOCK   0     /* Largest tx dma block, 0 for no limit */
+    #define RINGBUFFER_DMA_STRIPE_CHANNELS  4   /* Dma channels filling one ring in parallel, 0 to disable */
+    #define RINGBUFFER_DMA_STRIPE_DEPTH   8     /* Striped blocks in flight */
 
 #endif  // !__RINGBUFFER_CFG_H__
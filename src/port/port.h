@@ -7,6 +7,7 @@ extern "C" {
 
 #include <stdint.h>
 
+#include "port_compiler.h"
 #include "port_heap.h"
 #include "port_mem.h"
 
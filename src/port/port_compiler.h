@@ -0,0 +1,57 @@
+#ifndef __PORT_COMPILER_H__
+#define __PORT_COMPILER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_MSC_VER)
+#define RB_ALIGNED(n)             __declspec(align(n))
+#elif defined(__GNUC__) || defined(__clang__)
+#define RB_ALIGNED(n)             __attribute__((aligned(n)))
+#else
+#define RB_ALIGNED(n)
+#endif
+
+/* Full memory barrier, for hand-offs between a thread and an irq/engine */
+#if defined(_MSC_VER)
+#include <intrin.h>
+#if defined(_M_ARM) || defined(_M_ARM64)
+#define RB_MEMORY_BARRIER()       __dmb(0xB)
+#else
+#define RB_MEMORY_BARRIER()       _mm_mfence()
+#endif
+#elif defined(__GNUC__) || defined(__clang__)
+#define RB_MEMORY_BARRIER()       __sync_synchronize()
+#else
+#define RB_MEMORY_BARRIER()
+#endif
+
+/* Orders data accesses before an index store, or after an index load; compiler only on x86 */
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#if defined(_MSC_VER)
+#define RB_PUBLISH_BARRIER()      _ReadWriteBarrier()
+#elif defined(__GNUC__) || defined(__clang__)
+#define RB_PUBLISH_BARRIER()      __asm__ __volatile__("" ::: "memory")
+#else
+#define RB_PUBLISH_BARRIER()      RB_MEMORY_BARRIER()
+#endif
+#else
+#define RB_PUBLISH_BARRIER()      RB_MEMORY_BARRIER()
+#endif
+
+/* Compare and swap a 32-bit word, true if *ptr was old and is now val */
+#if defined(_MSC_VER)
+#define RB_ATOMIC_CAS(ptr, old, val)                                              \
+    (_InterlockedCompareExchange((volatile long *)(ptr), (long)(val), (long)(old)) == (long)(old))
+#elif defined(__GNUC__) || defined(__clang__)
+#define RB_ATOMIC_CAS(ptr, old, val)  __sync_bool_compare_and_swap(ptr, old, val)
+#else
+#define RB_ATOMIC_CAS(ptr, old, val)  ((*(ptr) == (old)) ? (*(ptr) = (val), 1) : 0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  //!__PORT_COMPILER_H__
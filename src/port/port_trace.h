@@ -0,0 +1,50 @@
+#ifndef __PORT_TRACE_H__
+#define __PORT_TRACE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Static tracepoints. With RINGBUFFER_USE_TRACE enabled and <sys/sdt.h>
+ * available, each RB_TRACEn() emits a USDT probe in provider "ringbuffer"
+ * which perf, bpftrace, systemtap or LTTng can attach to. An unattached
+ * probe is a single nop. Otherwise the macros expand to nothing, unless
+ * the port defines RB_TRACE3/4/5 itself before this header to route the
+ * probes to its own tracer.
+ *
+ *   bpftrace -e 'usdt:./libRingBuffer.so:ringbuffer:put { @[arg2] = count(); }'
+ */
+
+#if RINGBUFFER_USE_TRACE
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define RB_TRACE_USE_SDT            1
+#endif
+#endif
+#endif  /* RINGBUFFER_USE_TRACE */
+
+#if RB_TRACE_USE_SDT
+
+#define RB_TRACE3(name, a1, a2, a3)                 DTRACE_PROBE3(ringbuffer, name, a1, a2, a3)
+#define RB_TRACE4(name, a1, a2, a3, a4)             DTRACE_PROBE4(ringbuffer, name, a1, a2, a3, a4)
+#define RB_TRACE5(name, a1, a2, a3, a4, a5)         DTRACE_PROBE5(ringbuffer, name, a1, a2, a3, a4, a5)
+
+#elif !defined(RB_TRACE3)
+
+/* sizeof() keeps the arguments "used" without evaluating them */
+#define RB_TRACE3(name, a1, a2, a3)                 \
+    do { (void)sizeof(a1); (void)sizeof(a2); (void)sizeof(a3); } while (0)
+#define RB_TRACE4(name, a1, a2, a3, a4)             \
+    do { RB_TRACE3(name, a1, a2, a3); (void)sizeof(a4); } while (0)
+#define RB_TRACE5(name, a1, a2, a3, a4, a5)         \
+    do { RB_TRACE4(name, a1, a2, a3, a4); (void)sizeof(a5); } while (0)
+
+#endif  /* RB_TRACE_USE_SDT */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  //!__PORT_TRACE_H__
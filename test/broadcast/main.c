@@ -0,0 +1,131 @@
+#include "../../src/RingBufferBroadcast.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+// Test parameters
+#define RING_SIZE       (32)
+#define LAG_LIMIT       (16)
+
+static int g_errors = 0;
+
+#define TEST_CHECK(cond)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond);     \
+            g_errors++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static uint8_t g_data[4 * RING_SIZE];
+static uint8_t g_read[4 * RING_SIZE];
+
+int main()
+{
+    RingBuffer rb;
+    RingBufferBroadcast bc;
+    RingBufferBroadcastReaderStat stat;
+    const uint8_t *view;
+    uint32_t fast;
+    uint32_t slow;
+    uint32_t late;
+    uint32_t len;
+    uint32_t i;
+
+    for (i = 0; i < sizeof(g_data); i++) {
+        g_data[i] = (uint8_t)(i * 5 + 1);
+    }
+    TEST_CHECK(RingBufferCreate(&rb, RING_SIZE) == RB_OK);
+
+    printf("gated: the slowest reader holds the producer back\n");
+    TEST_CHECK(RingBufferBroadcastCreate(&bc, &rb, 0) == RB_OK);
+    TEST_CHECK(RingBufferBroadcastReaderAdd(&bc, &fast) == RB_OK);
+    TEST_CHECK(RingBufferBroadcastReaderAdd(&bc, &slow) == RB_OK);
+    TEST_CHECK(fast != slow);
+    TEST_CHECK(RingBufferBroadcastPut(&bc, g_data, 20) == 20);
+    TEST_CHECK(RingBufferBroadcastGet(&bc, fast, g_read, 20) == 20);
+    TEST_CHECK(memcmp(g_read, g_data, 20) == 0);
+    // slow still holds all 20, only size - 1 - 20 fit
+    TEST_CHECK(RingBufferBroadcastPut(&bc, &g_data[20], 20) == RING_SIZE - 1 - 20);
+    TEST_CHECK(RingBufferLenGet(&rb) == RING_SIZE - 1);
+    TEST_CHECK(RingBufferBroadcastLenGet(&bc, fast) == RING_SIZE - 1 - 20);
+    TEST_CHECK(RingBufferBroadcastLenGet(&bc, slow) == RING_SIZE - 1);
+
+    // Each cursor sees the same bytes, across the wrap
+    TEST_CHECK(RingBufferBroadcastGet(&bc, slow, g_read, sizeof(g_read)) == RING_SIZE - 1);
+    TEST_CHECK(memcmp(g_read, g_data, RING_SIZE - 1) == 0);
+    TEST_CHECK(RingBufferBroadcastGet(&bc, fast, g_read, sizeof(g_read)) == RING_SIZE - 1 - 20);
+    TEST_CHECK(memcmp(g_read, &g_data[20], RING_SIZE - 1 - 20) == 0);
+
+    // The ring backlog follows the slowest reader as of the last put
+    TEST_CHECK(RingBufferBroadcastPut(&bc, &g_data[RING_SIZE - 1], 10) == 10);
+    TEST_CHECK(RingBufferLenGet(&rb) == 10);
+    TEST_CHECK(RingBufferTotalOutGet(&rb) == RING_SIZE - 1);
+
+    printf("peek and release in place\n");
+    len = RingBufferBroadcastPeek(&bc, fast, &view);
+    TEST_CHECK(len > 0 && len <= 10);
+    TEST_CHECK(memcmp(view, &g_data[RING_SIZE - 1], len) == 0);
+    TEST_CHECK(RingBufferBroadcastRelease(&bc, fast, len) == RB_OK);
+    TEST_CHECK(RingBufferBroadcastRelease(&bc, fast, 11) == RB_ERROR_PARAM);
+    TEST_CHECK(RingBufferBroadcastGet(&bc, fast, g_read, sizeof(g_read)) == 10 - len);
+    TEST_CHECK(memcmp(g_read, &g_data[RING_SIZE - 1 + len], 10 - len) == 0);
+
+    printf("a late reader joins at the write position\n");
+    TEST_CHECK(RingBufferBroadcastReaderAdd(&bc, &late) == RB_OK);
+    TEST_CHECK(RingBufferBroadcastLenGet(&bc, late) == 0);
+    TEST_CHECK(RingBufferBroadcastReaderRemove(&bc, late) == RB_OK);
+    TEST_CHECK(RingBufferBroadcastLenGet(&bc, late) == 0);
+    TEST_CHECK(RingBufferBroadcastReaderRemove(&bc, late) == RB_ERROR_PARAM);
+    TEST_CHECK(RingBufferBroadcastDelete(&bc) == RB_OK);
+
+    printf("lag limit: a slow reader is dropped, not waited for\n");
+    TEST_CHECK(RingBufferBroadcastCreate(&bc, &rb, RING_SIZE) == RB_ERROR_PARAM);
+    TEST_CHECK(RingBufferBroadcastCreate(&bc, &rb, LAG_LIMIT) == RB_OK);
+    TEST_CHECK(RingBufferBroadcastReaderAdd(&bc, &fast) == RB_OK);
+    TEST_CHECK(RingBufferBroadcastReaderAdd(&bc, &slow) == RB_OK);
+    for (i = 0; i < 4; i++) {
+        TEST_CHECK(RingBufferBroadcastPut(&bc, &g_data[i * 10], 10) == 10);
+        TEST_CHECK(RingBufferBroadcastGet(&bc, fast, g_read, 10) == 10);
+        TEST_CHECK(memcmp(g_read, &g_data[i * 10], 10) == 0);
+    }
+    // slow fell 20 behind at the third put and was dropped then
+    TEST_CHECK(RingBufferBroadcastReaderStatGet(&bc, slow, &stat) == RB_OK);
+    TEST_CHECK(stat.dropped == 1 && stat.droppedTimes == 1);
+    TEST_CHECK(RingBufferBroadcastGet(&bc, slow, g_read, sizeof(g_read)) == 0);
+    TEST_CHECK(RingBufferBroadcastLenGet(&bc, slow) == 0);
+    TEST_CHECK(RingBufferBroadcastPeek(&bc, slow, &view) == 0);
+    TEST_CHECK(RingBufferBroadcastRelease(&bc, slow, 0) == RB_ERROR_INVALID);
+
+    // A reader dropped between peek and release must discard what it saw
+    len = RingBufferBroadcastPeek(&bc, fast, &view);
+    TEST_CHECK(len == 0);
+    TEST_CHECK(RingBufferBroadcastPut(&bc, &g_data[40], 10) == 10);
+    len = RingBufferBroadcastPeek(&bc, fast, &view);
+    TEST_CHECK(len > 0);
+    TEST_CHECK(RingBufferBroadcastPut(&bc, &g_data[50], 10) == 10);
+    TEST_CHECK(RingBufferBroadcastPut(&bc, &g_data[60], 10) == 10);
+    TEST_CHECK(RingBufferBroadcastRelease(&bc, fast, len) == RB_ERROR_INVALID);
+
+    printf("resync: back at the write position\n");
+    TEST_CHECK(RingBufferBroadcastResync(&bc, slow) == RB_OK);
+    TEST_CHECK(RingBufferBroadcastResync(&bc, fast) == RB_OK);
+    TEST_CHECK(RingBufferBroadcastPut(&bc, &g_data[70], 10) == 10);
+    TEST_CHECK(RingBufferBroadcastGet(&bc, slow, g_read, sizeof(g_read)) == 10);
+    TEST_CHECK(memcmp(g_read, &g_data[70], 10) == 0);
+    TEST_CHECK(RingBufferBroadcastReaderStatGet(&bc, slow, &stat) == RB_OK);
+    TEST_CHECK(stat.dropped == 0 && stat.lag == 0 && stat.totalOut == 80);
+    TEST_CHECK(RingBufferBroadcastReaderStatGet(&bc, fast, &stat) == RB_OK);
+    TEST_CHECK(stat.droppedTimes == 1 && stat.lag == 10 && stat.maxLag <= LAG_LIMIT);
+
+    TEST_CHECK(RingBufferBroadcastDelete(&bc) == RB_OK);
+    TEST_CHECK(RingBufferDelete(&rb) == RB_OK);
+
+    if (g_errors == 0) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED! (%d errors)\n", g_errors);
+    return 1;
+}
@@ -0,0 +1,158 @@
+#include "../../src/RingBuffer.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+// Test parameters
+#define RING_SIZE       (256)
+#define LINE            RINGBUFFER_CACHE_LINE_SIZE
+#define PERIPH_ADDR     (0x40001000)
+
+static int g_errors = 0;
+
+#define TEST_CHECK(cond)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond);     \
+            g_errors++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static RB_ALIGNED(RINGBUFFER_CACHE_LINE_SIZE) uint8_t g_txBuff[RING_SIZE];
+static RB_ALIGNED(RINGBUFFER_CACHE_LINE_SIZE) uint8_t g_rxBuff[RING_SIZE];
+
+/* Last cache operation and how many there were */
+static RB_ADDRESS g_cacheAddr;
+static uint32_t g_cacheSize;
+static uint32_t g_cleans;
+static uint32_t g_invalidates;
+
+static RB_ADDRESS g_det;
+static uint32_t g_size;
+static uint32_t g_configs;
+
+static void MockClean(RB_ADDRESS addr, uint32_t size)
+{
+    g_cacheAddr = addr;
+    g_cacheSize = size;
+    g_cleans++;
+}
+
+static void MockInvalidate(RB_ADDRESS addr, uint32_t size)
+{
+    g_cacheAddr = addr;
+    g_cacheSize = size;
+    g_invalidates++;
+}
+
+static int MockConfig(RB_ADDRESS src, RB_ADDRESS det, uint32_t size)
+{
+    (void)src;
+    g_det = det;
+    g_size = size;
+    g_configs++;
+    return 0;
+}
+
+static uint32_t MockRecvedLen(void)
+{
+    return 0;
+}
+
+/* The last cache operation covered exactly [off, off + size) of `buff` */
+static int CacheRange(const uint8_t *buff, uint32_t off, uint32_t size)
+{
+    return g_cacheAddr == (RB_ADDRESS)(uintptr_t)&buff[off] && g_cacheSize == size;
+}
+
+int main()
+{
+    RingBuffer tx;
+    RingBuffer rx;
+    uint8_t data[RING_SIZE];
+
+    memset(data, 0xA5, sizeof(data));
+
+    printf("clean per put, line aligned\n");
+    TEST_CHECK(RingBufferInit(&tx, g_txBuff, RING_SIZE) == RB_OK);
+    TEST_CHECK(RingBufferDMATxDeviceRegister(&tx, MockConfig, NULL, NULL, MockRecvedLen,
+                                             MockClean, MockInvalidate) == RB_OK);
+    TEST_CHECK(RingBufferDMATxStart(&tx, PERIPH_ADDR) == RB_OK);
+    TEST_CHECK(RingBufferPut(&tx, data, 10) == 10);
+    TEST_CHECK(g_cleans == 1 && CacheRange(g_txBuff, 0, LINE));
+    // The engine sees the data only after the clean
+    TEST_CHECK(g_configs == 1 && g_size == 10);
+    TEST_CHECK(RingBufferDMAComplete(&tx) == RB_OK);
+
+    printf("batched puts clean once at the end\n");
+    g_cleans = 0;
+    g_configs = 0;
+    TEST_CHECK(RingBufferCacheBatchBegin(&tx) == RB_OK);
+    TEST_CHECK(RingBufferCacheBatchBegin(&tx) == RB_ERROR_LOCKED);
+    TEST_CHECK(RingBufferPut(&tx, data, 30) == 30);
+    TEST_CHECK(RingBufferPut(&tx, data, 30) == 30);
+    TEST_CHECK(RingBufferPut(&tx, data, 30) == 30);
+    TEST_CHECK(g_cleans == 0 && g_configs == 0);
+    TEST_CHECK(RingBufferCacheBatchEnd(&tx) == RB_OK);
+    TEST_CHECK(RingBufferCacheBatchEnd(&tx) == RB_ERROR_UNLOCKED);
+    // [10, 100) rounds out to [0, 128)
+    TEST_CHECK(g_cleans == 1 && CacheRange(g_txBuff, 0, 2 * LINE));
+    TEST_CHECK(g_configs == 1 && g_size == 90);
+    TEST_CHECK(RingBufferDMAComplete(&tx) == RB_OK);
+
+    printf("a batch across the wrap cleans each side\n");
+    g_cleans = 0;
+    TEST_CHECK(RingBufferPut(&tx, data, 100) == 100);
+    TEST_CHECK(RingBufferDMAComplete(&tx) == RB_OK);
+    g_cleans = 0;
+    // tail at 200: [200, 256) then [0, 20)
+    TEST_CHECK(RingBufferCacheBatchBegin(&tx) == RB_OK);
+    TEST_CHECK(RingBufferPut(&tx, data, 40) == 40);
+    TEST_CHECK(RingBufferPut(&tx, data, 36) == 36);
+    TEST_CHECK(g_cleans == 1 && CacheRange(g_txBuff, 3 * LINE, LINE));
+    TEST_CHECK(RingBufferCacheBatchEnd(&tx) == RB_OK);
+    TEST_CHECK(g_cleans == 2 && CacheRange(g_txBuff, 0, LINE));
+    TEST_CHECK(RingBufferDMAComplete(&tx) == RB_OK);
+    TEST_CHECK(RingBufferDMAComplete(&tx) == RB_OK);
+    TEST_CHECK(RingBufferLenGet(&tx) == 0);
+    TEST_CHECK(RingBufferDMADeviceUnregister(&tx) == RB_OK);
+    TEST_CHECK(RingBufferDeinit(&tx) == RB_OK);
+
+    printf("gets invalidate the readable region once\n");
+    TEST_CHECK(RingBufferInit(&rx, g_rxBuff, RING_SIZE) == RB_OK);
+    TEST_CHECK(RingBufferDMADeviceRegister(&rx, MockConfig, NULL, NULL, MockRecvedLen,
+                                           MockClean, MockInvalidate) == RB_OK);
+    TEST_CHECK(RingBufferDMAConfig(&rx, PERIPH_ADDR, 100) == RB_OK);
+    TEST_CHECK(g_det == (RB_ADDRESS)(uintptr_t)&g_rxBuff[0]);
+    TEST_CHECK(RingBufferDMAStart(&rx) == RB_OK);
+    TEST_CHECK(RingBufferDMAComplete(&rx) == RB_OK);
+    TEST_CHECK(RingBufferGet(&rx, data, 10) == 10);
+    TEST_CHECK(g_invalidates == 1 && CacheRange(g_rxBuff, 0, 2 * LINE));
+    TEST_CHECK(RingBufferGet(&rx, data, 10) == 10);
+    TEST_CHECK(g_invalidates == 1);
+    // The line the engine writes next is invalidated again before reading it
+    TEST_CHECK(RingBufferGet(&rx, data, 50) == 50);
+    TEST_CHECK(g_invalidates == 2 && CacheRange(g_rxBuff, LINE, LINE));
+    TEST_CHECK(RingBufferGet(&rx, data, 30) == 30);
+    TEST_CHECK(g_invalidates == 3);
+
+    printf("a block ending on a line boundary\n");
+    TEST_CHECK(RingBufferDMAConfig(&rx, PERIPH_ADDR, 2 * LINE - 100) == RB_OK);
+    TEST_CHECK(RingBufferDMAStart(&rx) == RB_OK);
+    TEST_CHECK(RingBufferDMAComplete(&rx) == RB_OK);
+    TEST_CHECK(RingBufferGet(&rx, data, 1) == 1);
+    TEST_CHECK(g_invalidates == 4 && CacheRange(g_rxBuff, LINE, LINE));
+    TEST_CHECK(RingBufferGet(&rx, data, sizeof(data)) == 2 * LINE - 100 - 1);
+    TEST_CHECK(g_invalidates == 4);
+    TEST_CHECK(g_cleans == 2);
+    TEST_CHECK(RingBufferDMADeviceUnregister(&rx) == RB_OK);
+    TEST_CHECK(RingBufferDeinit(&rx) == RB_OK);
+
+    if (g_errors == 0) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED! (%d errors)\n", g_errors);
+    return 1;
+}
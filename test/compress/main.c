@@ -0,0 +1,190 @@
+#include "../../src/RingBufferCompress.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+// Test parameters
+#define BLOCK_SIZE      (1024)
+#define SRC_SIZE        (3000)
+#define FRAME_SIZE      (700)           // Smaller than a raw frame, frames wrap all the time
+#define OUT_SIZE        (2000)
+#define STREAM_SIZE     (64 * 1024)
+
+static int g_errors = 0;
+
+#define TEST_CHECK(cond)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond);     \
+            g_errors++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static uint32_t g_table[RINGBUFFER_LZ_TABLE_SIZE];
+static uint8_t g_comp[RINGBUFFER_FRAME_HEADER_SIZE + RINGBUFFER_LZ_BOUND(STREAM_SIZE)];
+static uint8_t g_plain[STREAM_SIZE];
+static uint8_t g_out[STREAM_SIZE];
+static uint32_t g_seed = 12345;
+
+static uint8_t rnd(void)
+{
+    g_seed ^= g_seed << 13;
+    g_seed ^= g_seed >> 17;
+    g_seed ^= g_seed << 5;
+    return (uint8_t)g_seed;
+}
+
+// Compresses and expands `len` bytes of g_plain, returns the compressed size
+static uint32_t roundTrip(uint32_t len)
+{
+    uint32_t comp;
+
+    comp = RingBufferLZCompress(g_plain, len, g_comp, sizeof(g_comp), g_table);
+    TEST_CHECK(comp > 0 && comp <= RINGBUFFER_LZ_BOUND(len));
+    memset(g_out, 0, len);
+    TEST_CHECK(RingBufferLZDecompress(g_comp, comp, g_out, len) == (int)len);
+    TEST_CHECK(memcmp(g_out, g_plain, len) == 0);
+
+    return comp;
+}
+
+static void drain(RingBuffer *rb)
+{
+    while (RingBufferGet(rb, g_out, sizeof(g_out))) {
+        // Drop everything
+    }
+}
+
+// Runs compressor and decompressor until the stream is through, keeping the rings small
+static void pump(RingBuffer *src, RingBufferCompressor *c, RingBufferDecompressor *d, RingBuffer *out)
+{
+    uint32_t put = 0;
+    uint32_t got = 0;
+    uint32_t idle = 0;
+    uint32_t n;
+
+    while (got < STREAM_SIZE && idle < 1000) {
+        n = RingBufferPut(src, &g_plain[put], STREAM_SIZE - put < 777 ? STREAM_SIZE - put : 777);
+        put += n;
+        TEST_CHECK(RingBufferCompressorRun(c, put == STREAM_SIZE) == RB_OK);
+        TEST_CHECK(RingBufferDecompressorRun(d) == RB_OK);
+        n = RingBufferGet(out, &g_out[got], STREAM_SIZE - got);
+        got += n;
+        idle = n ? 0 : idle + 1;
+    }
+
+    TEST_CHECK(got == STREAM_SIZE);
+    TEST_CHECK(memcmp(g_out, g_plain, STREAM_SIZE) == 0);
+}
+
+int main()
+{
+    RingBuffer src;
+    RingBuffer frames;
+    RingBuffer out;
+    RingBufferCompressor c;
+    RingBufferDecompressor d;
+    uint8_t bad[RINGBUFFER_FRAME_HEADER_SIZE + 16];
+    uint32_t comp;
+    uint32_t i;
+
+    printf("incompressible input\n");
+    for (i = 0; i < STREAM_SIZE; i++) {
+        g_plain[i] = rnd();
+    }
+    comp = roundTrip(STREAM_SIZE);
+    TEST_CHECK(comp >= STREAM_SIZE);
+
+    printf("all-zero run\n");
+    memset(g_plain, 0, STREAM_SIZE);
+    comp = roundTrip(STREAM_SIZE);
+    TEST_CHECK(comp < STREAM_SIZE / 100);
+
+    printf("short and mixed input\n");
+    for (i = 0; i < STREAM_SIZE; i++) {
+        g_plain[i] = (i / 512) % 2 ? rnd() : (uint8_t)("ring buffer "[i % 12]);
+    }
+    for (i = 1; i <= 20; i++) {
+        roundTrip(i);
+    }
+    roundTrip(STREAM_SIZE);
+
+    printf("corrupt streams\n");
+    // Match offset 0
+    TEST_CHECK(RingBufferLZDecompress((const uint8_t *)"\x10" "a" "\x00\x00", 4, g_out, 64) == RB_ERROR_INVALID);
+    // Match offset before the start of the output
+    TEST_CHECK(RingBufferLZDecompress((const uint8_t *)"\x10" "a" "\x05\x00", 4, g_out, 64) == RB_ERROR_INVALID);
+    // Literal run longer than the input
+    TEST_CHECK(RingBufferLZDecompress((const uint8_t *)"\x50" "ab", 3, g_out, 64) == RB_ERROR_INVALID);
+    // Output larger than the buffer
+    memset(g_plain, 0, BLOCK_SIZE);
+    comp = RingBufferLZCompress(g_plain, BLOCK_SIZE, g_comp, sizeof(g_comp), g_table);
+    TEST_CHECK(RingBufferLZDecompress(g_comp, comp, g_out, BLOCK_SIZE - 1) == RB_ERROR_INVALID);
+    // Cut inside the match length extension
+    TEST_CHECK(RingBufferLZDecompress(g_comp, comp - 2, g_out, BLOCK_SIZE) != BLOCK_SIZE);
+
+    printf("stage round trip across the ring wraps\n");
+    // Repeats with a period that puts matches across every wrap of the source ring
+    for (i = 0; i < STREAM_SIZE; i++) {
+        g_plain[i] = (i / 4096) % 3 == 2 ? rnd() : (uint8_t)(i % 97);
+    }
+    TEST_CHECK(RingBufferCreate(&src, SRC_SIZE) == RB_OK);
+    TEST_CHECK(RingBufferCreate(&frames, FRAME_SIZE) == RB_OK);
+    TEST_CHECK(RingBufferCreate(&out, OUT_SIZE) == RB_OK);
+    TEST_CHECK(RingBufferCompressorCreate(&c, &src, &frames, -1, BLOCK_SIZE) == RB_OK);
+    TEST_CHECK(RingBufferDecompressorCreate(&d, &frames, -1, &out, BLOCK_SIZE) == RB_OK);
+    pump(&src, &c, &d, &out);
+    TEST_CHECK(c.rawBytes == STREAM_SIZE && d.rawBytes == STREAM_SIZE);
+    TEST_CHECK(c.compBytes == d.compBytes && c.compBytes < STREAM_SIZE);
+    printf("  %llu bytes in %llu bytes of frames\n",
+           (unsigned long long)c.rawBytes, (unsigned long long)c.compBytes);
+
+    printf("corrupt frames\n");
+    // Raw length above the block size
+    memset(bad, 0, sizeof(bad));
+    bad[1] = (BLOCK_SIZE * 2) >> 8;
+    bad[4] = 4;
+    TEST_CHECK(RingBufferPut(&frames, bad, RINGBUFFER_FRAME_HEADER_SIZE + 4) == RINGBUFFER_FRAME_HEADER_SIZE + 4);
+    TEST_CHECK(RingBufferDecompressorRun(&d) == RB_ERROR_INVALID);
+    RingBufferDecompressorDelete(&d);
+    drain(&frames);
+
+    // Payload one byte short of what the raw length needs
+    TEST_CHECK(RingBufferDecompressorCreate(&d, &frames, -1, &out, BLOCK_SIZE) == RB_OK);
+    memset(g_plain, 0, BLOCK_SIZE);
+    comp = RingBufferLZCompress(g_plain, BLOCK_SIZE, &bad[RINGBUFFER_FRAME_HEADER_SIZE], 16, g_table);
+    TEST_CHECK(comp > 0 && comp <= 16);
+    bad[0] = (uint8_t)BLOCK_SIZE;
+    bad[1] = (uint8_t)(BLOCK_SIZE >> 8);
+    bad[2] = bad[3] = 0;
+    bad[4] = (uint8_t)(comp - 1);
+    bad[5] = bad[6] = bad[7] = 0;
+    TEST_CHECK(RingBufferPut(&frames, bad, RINGBUFFER_FRAME_HEADER_SIZE + comp - 1) == RINGBUFFER_FRAME_HEADER_SIZE + comp - 1);
+    TEST_CHECK(RingBufferDecompressorRun(&d) == RB_ERROR_INVALID);
+
+    // A frame cut short is kept until the rest arrives, not misread
+    RingBufferDecompressorDelete(&d);
+    drain(&frames);
+    TEST_CHECK(RingBufferDecompressorCreate(&d, &frames, -1, &out, BLOCK_SIZE) == RB_OK);
+    bad[4] = (uint8_t)comp;
+    TEST_CHECK(RingBufferPut(&frames, bad, RINGBUFFER_FRAME_HEADER_SIZE + comp - 1) == RINGBUFFER_FRAME_HEADER_SIZE + comp - 1);
+    TEST_CHECK(RingBufferDecompressorRun(&d) == RB_OK);
+    TEST_CHECK(RingBufferLenGet(&out) == 0);
+    TEST_CHECK(RingBufferPut(&frames, &bad[RINGBUFFER_FRAME_HEADER_SIZE + comp - 1], 1) == 1);
+    TEST_CHECK(RingBufferDecompressorRun(&d) == RB_OK);
+    TEST_CHECK(RingBufferLenGet(&out) == BLOCK_SIZE);
+
+    RingBufferCompressorDelete(&c);
+    RingBufferDecompressorDelete(&d);
+    RingBufferDelete(&src);
+    RingBufferDelete(&frames);
+    RingBufferDelete(&out);
+
+    if (g_errors == 0) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED! (%d errors)\n", g_errors);
+    return 1;
+}
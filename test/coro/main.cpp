@@ -0,0 +1,134 @@
+#include "../../src/RingBufferCoro.hpp"
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+// Test parameters
+#define RING_SIZE       (16)
+#define TOTAL_BYTES     (100000)
+#define WRITE_CHUNK     (7)
+#define READ_CHUNK      (5)
+
+static int g_errors = 0;
+
+#define TEST_CHECK(cond)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond);     \
+            g_errors++;                                                     \
+        }                                                                   \
+    } while (0)
+
+struct Counts {
+    uint32_t written = 0;
+    uint32_t read = 0;
+    uint32_t bad = 0;
+    uint32_t writeZero = 0;             // Completions without a byte, each side its own
+    uint32_t readZero = 0;
+};
+
+static RingBufferTask Producer(RingBufferAsync &ring, Counts &counts)
+{
+    uint8_t chunk[WRITE_CHUNK];
+    uint32_t len;
+    uint32_t i;
+
+    while (counts.written < TOTAL_BYTES) {
+        len = TOTAL_BYTES - counts.written < WRITE_CHUNK ? TOTAL_BYTES - counts.written : WRITE_CHUNK;
+        for (i = 0; i < len; i++) {
+            chunk[i] = (uint8_t)(counts.written + i);
+        }
+        len = co_await ring.Write(chunk, len);
+        if (len == 0) {
+            counts.writeZero++;
+        }
+        counts.written += len;
+    }
+}
+
+static RingBufferTask Consumer(RingBufferAsync &ring, Counts &counts)
+{
+    uint8_t chunk[READ_CHUNK];
+    uint32_t len;
+    uint32_t i;
+
+    while (counts.read < TOTAL_BYTES) {
+        len = co_await ring.Read(chunk, sizeof(chunk));
+        if (len == 0) {
+            counts.readZero++;
+        }
+        for (i = 0; i < len; i++) {
+            if (chunk[i] != (uint8_t)(counts.read + i)) {
+                counts.bad++;
+            }
+        }
+        counts.read += len;
+    }
+}
+
+int main()
+{
+    RingBuffer rb;
+
+    TEST_CHECK(RingBufferCreate(&rb, RING_SIZE) == RB_OK);
+
+    printf("one executor\n");
+    {
+        RingBufferExecutor executor;
+        RingBufferAsync ring(&rb, executor);
+        Counts counts;
+
+        // The consumer runs first and parks on the empty ring
+        executor.Spawn(Consumer(ring, counts));
+        executor.Spawn(Producer(ring, counts));
+        executor.Run();
+        TEST_CHECK(counts.written == TOTAL_BYTES && counts.read == TOTAL_BYTES);
+        TEST_CHECK(counts.bad == 0 && counts.writeZero == 0 && counts.readZero == 0);
+        TEST_CHECK(RingBufferLenGet(&rb) == 0);
+    }
+
+    printf("executors on two threads\n");
+    {
+        RingBufferExecutor readExecutor;
+        RingBufferExecutor writeExecutor;
+        RingBufferAsync ring(&rb, readExecutor);
+        Counts counts;
+
+        writeExecutor.Spawn(Producer(ring, counts));
+        readExecutor.Spawn(Consumer(ring, counts));
+        std::thread writer([&writeExecutor] { writeExecutor.Run(); });
+        readExecutor.Run();
+        writer.join();
+        TEST_CHECK(counts.written == TOTAL_BYTES && counts.read == TOTAL_BYTES);
+        TEST_CHECK(counts.bad == 0 && counts.writeZero == 0 && counts.readZero == 0);
+        TEST_CHECK(RingBufferTotalInGet(&rb) == 2ULL * TOTAL_BYTES);
+        TEST_CHECK(RingBufferTotalOutGet(&rb) == 2ULL * TOTAL_BYTES);
+    }
+
+    printf("stop with a parked reader\n");
+    {
+        RingBufferExecutor executor;
+        RingBufferAsync ring(&rb, executor);
+        Counts counts;
+
+        executor.Spawn(Consumer(ring, counts));
+        std::thread stopper([&executor] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            executor.Stop();
+        });
+        // Nothing is ever written, only Stop() gets Run() back
+        executor.Run();
+        stopper.join();
+        TEST_CHECK(counts.read == 0);
+    }
+
+    TEST_CHECK(RingBufferDelete(&rb) == RB_OK);
+
+    if (g_errors == 0) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED! (%d errors)\n", g_errors);
+    return 1;
+}
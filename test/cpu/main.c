@@ -2,6 +2,7 @@
 #include "../../src/RingBuffer.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #define TEST_LOOP                           (1000000)
@@ -23,6 +24,174 @@ static void printInfo(RingBuffer *rb, const char *tag)
     printf("ring buffer total out %llu\n", RingBufferTotalOutGet(rb));
 }
 
+#define TEST_CHECK(cond)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond);     \
+            errors++;                                                       \
+        }                                                                   \
+    } while (0)
+
+/* Moves an empty ring's head and tail to `offset` */
+static void testRingOffsetSet(RingBuffer *ring, uint32_t offset)
+{
+    RingBufferPut(ring, put_buff, offset);
+    RingBufferGet(ring, get_buff, offset);
+}
+
+static void testTransferInvert(void *arg, uint8_t *data, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        data[i] = (uint8_t)~data[i];
+    }
+    *(uint32_t *)arg += size;
+}
+
+static int testTransfer(void)
+{
+    /* Source and destination offsets: src wraps, det wraps, both wrap (three segments) */
+    static const uint32_t offset[][2] = { { 12, 0 }, { 0, 12 }, { 10, 13 } };
+    static uint8_t srcMem[16];
+    static uint8_t detMem[16];
+    RingBuffer src;
+    RingBuffer det;
+    uint8_t data[10];
+    uint32_t seen;
+    int errors = 0;
+
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(0xa0 + i);
+    }
+
+    for (uint32_t n = 0; n < sizeof(offset) / sizeof(offset[0]); n++) {
+        for (uint32_t cb = 0; cb < 2; cb++) {
+            RingBufferInit(&src, srcMem, sizeof(srcMem));
+            RingBufferInit(&det, detMem, sizeof(detMem));
+            testRingOffsetSet(&src, offset[n][0]);
+            testRingOffsetSet(&det, offset[n][1]);
+
+            TEST_CHECK(RingBufferPut(&src, data, sizeof(data)) == sizeof(data));
+            seen = 0;
+            TEST_CHECK(RingBufferTransfer(&det, &src, 100, cb ? testTransferInvert : NULL, &seen) == sizeof(data));
+            TEST_CHECK(seen == (cb ? sizeof(data) : 0));
+            TEST_CHECK(RingBufferLenGet(&src) == 0);
+            TEST_CHECK(RingBufferLenGet(&det) == sizeof(data));
+            TEST_CHECK(RingBufferGet(&det, get_buff, sizeof(get_buff)) == sizeof(data));
+            for (uint32_t i = 0; i < sizeof(data); i++) {
+                TEST_CHECK(get_buff[i] == (uint8_t)(cb ? ~data[i] : data[i]));
+            }
+        }
+    }
+
+    /* Bounded by the destination space */
+    RingBufferInit(&src, srcMem, sizeof(srcMem));
+    RingBufferInit(&det, detMem, sizeof(detMem));
+    TEST_CHECK(RingBufferPut(&det, data, 8) == 8);
+    TEST_CHECK(RingBufferPut(&src, data, sizeof(data)) == sizeof(data));
+    TEST_CHECK(RingBufferTransfer(&det, &src, 100, NULL, NULL) == sizeof(detMem) - 1 - 8);
+    TEST_CHECK(RingBufferLenGet(&src) == sizeof(data) - (sizeof(detMem) - 1 - 8));
+
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+    /* A batched destination keeps the moved bytes pending, in order behind earlier puts */
+    RingBufferInit(&src, srcMem, sizeof(srcMem));
+    RingBufferInit(&det, detMem, sizeof(detMem));
+    testRingOffsetSet(&det, 12);
+    TEST_CHECK(RingBufferPublishBatchSet(&det, 14) == RB_OK);
+    TEST_CHECK(RingBufferPut(&det, data, 3) == 3);
+    TEST_CHECK(RingBufferPut(&src, &data[3], 7) == 7);
+    TEST_CHECK(RingBufferTransfer(&det, &src, 100, NULL, NULL) == 7);
+    TEST_CHECK(RingBufferLenGet(&det) == 0);
+    TEST_CHECK(RingBufferSpaceGet(&det) == sizeof(detMem) - 1 - 10);
+    TEST_CHECK(RingBufferFlush(&det) == RB_OK);
+    TEST_CHECK(RingBufferLenGet(&det) == 10);
+    TEST_CHECK(RingBufferGet(&det, get_buff, sizeof(get_buff)) == 10);
+    TEST_CHECK(memcmp(get_buff, data, 10) == 0);
+
+    /* An empty batched source asks its producer to publish the next put at once */
+    RingBufferInit(&src, srcMem, sizeof(srcMem));
+    RingBufferInit(&det, detMem, sizeof(detMem));
+    TEST_CHECK(RingBufferPublishBatchSet(&src, 14) == RB_OK);
+    TEST_CHECK(RingBufferPut(&src, data, 3) == 3);
+    TEST_CHECK(RingBufferTransfer(&det, &src, 100, NULL, NULL) == 0);
+    TEST_CHECK(src.consumerWaiting == 1);
+    TEST_CHECK(RingBufferPut(&src, &data[3], 2) == 2);
+    TEST_CHECK(RingBufferTransfer(&det, &src, 100, NULL, NULL) == 5);
+    TEST_CHECK(RingBufferGet(&det, get_buff, sizeof(get_buff)) == 5);
+    TEST_CHECK(memcmp(get_buff, data, 5) == 0);
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+
+    printf("transfer: %s\n", errors ? "FAILED" : "PASSED");
+
+    return errors;
+}
+
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+
+static int testDeferredPublish(void)
+{
+    RingBuffer batch;
+    static uint8_t mem[64];
+    uint8_t data[32];
+    int errors = 0;
+
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)i;
+    }
+
+    RingBufferInit(&batch, mem, sizeof(mem));
+    TEST_CHECK(RingBufferPublishBatchSet(&batch, 16) == RB_OK);
+
+    /* Below the batch nothing is visible yet, but the space is taken */
+    TEST_CHECK(RingBufferPut(&batch, data, 10) == 10);
+    TEST_CHECK(RingBufferLenGet(&batch) == 0);
+    TEST_CHECK(RingBufferTotalInGet(&batch) == 0);
+    TEST_CHECK(RingBufferSpaceGet(&batch) == sizeof(mem) - 1 - 10);
+
+    /* Crossing it publishes everything put so far */
+    TEST_CHECK(RingBufferPut(&batch, &data[10], 10) == 10);
+    TEST_CHECK(RingBufferLenGet(&batch) == 20);
+    TEST_CHECK(RingBufferGet(&batch, get_buff, sizeof(get_buff)) == 20);
+    TEST_CHECK(memcmp(get_buff, data, 20) == 0);
+
+    /* A get that found the ring empty makes the next put publish at once */
+    TEST_CHECK(RingBufferGet(&batch, get_buff, sizeof(get_buff)) == 0);
+    TEST_CHECK(RingBufferPut(&batch, data, 1) == 1);
+    TEST_CHECK(RingBufferLenGet(&batch) == 1);
+    TEST_CHECK(RingBufferPut(&batch, data, 1) == 1);
+    TEST_CHECK(RingBufferLenGet(&batch) == 1);
+    TEST_CHECK(RingBufferGet(&batch, get_buff, sizeof(get_buff)) == 1);
+    TEST_CHECK(RingBufferFlush(&batch) == RB_OK);
+    TEST_CHECK(RingBufferGet(&batch, get_buff, sizeof(get_buff)) == 1);
+
+    /* Flush publishes a partial batch, across the wrap too */
+    for (uint32_t i = 0; i < 8; i++) {
+        TEST_CHECK(RingBufferPut(&batch, data, 7) == 7);
+        TEST_CHECK(RingBufferFlush(&batch) == RB_OK);
+        TEST_CHECK(RingBufferGet(&batch, get_buff, sizeof(get_buff)) == 7);
+    }
+    TEST_CHECK(RingBufferLenGet(&batch) == 0);
+
+    /* Switching back to 0 publishes what is pending */
+    TEST_CHECK(RingBufferPut(&batch, data, 5) == 5);
+    TEST_CHECK(RingBufferPublishBatchSet(&batch, 0) == RB_OK);
+    TEST_CHECK(RingBufferLenGet(&batch) == 5);
+    TEST_CHECK(RingBufferPut(&batch, data, 5) == 5);
+    TEST_CHECK(RingBufferLenGet(&batch) == 10);
+
+    /* Pending bytes die with the ring */
+    TEST_CHECK(RingBufferPublishBatchSet(&batch, 16) == RB_OK);
+    TEST_CHECK(RingBufferPut(&batch, data, 5) == 5);
+    TEST_CHECK(RingBufferDeinit(&batch) == RB_OK);
+    TEST_CHECK(RingBufferTotalInGet(&batch) == 0);
+    TEST_CHECK(batch.publishEvery == 0 && batch.pendLen == 0);
+
+    printf("deferred publish: %s\n", errors ? "FAILED" : "PASSED");
+
+    return errors;
+}
+
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+
 int main()
 {
     int status;
@@ -87,13 +256,22 @@ int main()
 
     printInfo(&rb, "before delete");
 
-    status = RingBufferDelete(&rb);
-    if (status) {
-        printf("delete ring buffer fail(%d)\n", status);
-        return status;
+    if (testTransfer()) {
+        status = RB_ERROR;
+    }
+
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+    if (testDeferredPublish()) {
+        status = RB_ERROR;
+    }
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+
+    if (RingBufferDelete(&rb)) {
+        printf("delete ring buffer fail\n");
+        return RB_ERROR;
     } else {
         printf("delete ring buffer succ\n");
     }
 
-    return 0;
+    return status;
 }
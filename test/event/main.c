@@ -0,0 +1,101 @@
+#include "../../src/RingBufferEvent.h"
+#include <poll.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+// Test parameters
+#define RING_SIZE       (64)
+
+static int g_errors = 0;
+
+#define TEST_CHECK(cond)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond);     \
+            g_errors++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static uint8_t g_data[RING_SIZE];
+static uint8_t g_read[RING_SIZE];
+
+// Whether the fd is readable right now
+static int readable(int fd)
+{
+    struct pollfd pfd = { fd, POLLIN, 0 };
+
+    return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN);
+}
+
+int main()
+{
+    RingBuffer rb;
+    RingBufferEvent ev;
+    int dataFd;
+    int spaceFd;
+
+    for (uint32_t i = 0; i < RING_SIZE; i++) {
+        g_data[i] = (uint8_t)(i * 3 + 1);
+    }
+
+    TEST_CHECK(RingBufferCreate(&rb, RING_SIZE) == RB_OK);
+    TEST_CHECK(RingBufferEventCreate(&ev, &rb) == RB_OK);
+    dataFd = RingBufferEventDataFdGet(&ev);
+    spaceFd = RingBufferEventSpaceFdGet(&ev);
+    TEST_CHECK(dataFd >= 0 && spaceFd >= 0);
+
+    printf("data arm: fires once enough is in\n");
+    TEST_CHECK(RingBufferEventDataArm(&ev, 10) == 0);
+    TEST_CHECK(RingBufferEventPut(&ev, g_data, 6) == 6);
+    TEST_CHECK(!readable(dataFd));
+    TEST_CHECK(RingBufferEventPut(&ev, &g_data[6], 6) == 6);
+    TEST_CHECK(readable(dataFd));
+    TEST_CHECK(ev.dataSignals == 1);
+    // Already there: returns the length, nothing armed
+    TEST_CHECK(RingBufferEventDataArm(&ev, 10) == 12);
+    TEST_CHECK(!readable(dataFd));
+    TEST_CHECK(RingBufferEventGet(&ev, g_read, RING_SIZE) == 12);
+    TEST_CHECK(memcmp(g_read, g_data, 12) == 0);
+
+    printf("data arm: a want above capacity is capped\n");
+    TEST_CHECK(RingBufferEventDataArm(&ev, 1000) == 0);
+    TEST_CHECK(ev.dataWant == RING_SIZE - 1);
+    TEST_CHECK(RingBufferEventPut(&ev, g_data, RING_SIZE) == RING_SIZE - 1);
+    TEST_CHECK(readable(dataFd));
+
+    printf("space arm: fires once enough is free\n");
+    TEST_CHECK(RingBufferEventSpaceArm(&ev, 20) == 0);
+    TEST_CHECK(RingBufferEventGet(&ev, g_read, 10) == 10);
+    TEST_CHECK(!readable(spaceFd));
+    TEST_CHECK(RingBufferEventGet(&ev, g_read, 10) == 10);
+    TEST_CHECK(readable(spaceFd));
+    // Capped like the data side: fires once the ring is empty
+    TEST_CHECK(RingBufferEventSpaceArm(&ev, 1000) == 0);
+    TEST_CHECK(RingBufferEventGet(&ev, g_read, RING_SIZE) == RING_SIZE - 1 - 20);
+    TEST_CHECK(readable(spaceFd));
+    TEST_CHECK(RingBufferEventSpaceArm(&ev, 1000) == RING_SIZE - 1);
+
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+    printf("data arm on a batched ring: the next put publishes\n");
+    TEST_CHECK(RingBufferPublishBatchSet(&rb, 32) == RB_OK);
+    TEST_CHECK(RingBufferEventDataArm(&ev, 1) == 0);
+    TEST_CHECK(rb.consumerWaiting == 1);
+    TEST_CHECK(RingBufferEventPut(&ev, g_data, 4) == 4);
+    TEST_CHECK(RingBufferLenGet(&rb) == 4);
+    TEST_CHECK(readable(dataFd));
+    TEST_CHECK(RingBufferEventGet(&ev, g_read, RING_SIZE) == 4);
+    TEST_CHECK(RingBufferPublishBatchSet(&rb, 0) == RB_OK);
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+
+    TEST_CHECK(RingBufferEventDelete(&ev) == RB_OK);
+    TEST_CHECK(RingBufferDelete(&rb) == RB_OK);
+
+    if (g_errors == 0) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED! (%d errors)\n", g_errors);
+    return 1;
+}
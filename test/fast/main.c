@@ -0,0 +1,123 @@
+#include "../../src/RingBufferFast.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+// Test parameters
+#define RING_SIZE       (32)
+#define THREAD_BYTES    (1000000)
+
+static int g_errors = 0;
+
+#define TEST_CHECK(cond)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond);     \
+            g_errors++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static RingBuffer g_rb;
+
+static void *Producer(void *arg)
+{
+    uint32_t i;
+
+    (void)arg;
+    for (i = 0; i < THREAD_BYTES; ) {
+        if (RingBufferFastPush(&g_rb, (uint8_t)i)) {
+            i++;
+        } else {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+int main()
+{
+    pthread_t thread;
+    uint8_t in[RING_SIZE * 2];
+    uint8_t out[RING_SIZE * 2];
+    uint8_t byte = 0;
+    uint32_t i;
+    uint32_t j;
+
+    for (i = 0; i < sizeof(in); i++) {
+        in[i] = (uint8_t)(i + 1);
+    }
+    TEST_CHECK(RingBufferCreate(&g_rb, RING_SIZE) == RB_OK);
+
+    printf("push and pop\n");
+    TEST_CHECK(RingBufferFastPop(&g_rb, &byte) == 0);
+    TEST_CHECK(RingBufferFastPeek(&g_rb, &byte) == 0);
+    for (i = 0; i < RING_SIZE - 1; i++) {
+        TEST_CHECK(RingBufferFastPush(&g_rb, in[i]) == 1);
+    }
+    TEST_CHECK(RingBufferFastPush(&g_rb, 0) == 0);
+    TEST_CHECK(RingBufferFastLenGet(&g_rb) == RING_SIZE - 1);
+    TEST_CHECK(RingBufferLenGet(&g_rb) == RING_SIZE - 1);
+    TEST_CHECK(RingBufferFastPeek(&g_rb, &byte) == 1 && byte == in[0]);
+    for (i = 0; i < RING_SIZE - 1; i++) {
+        TEST_CHECK(RingBufferFastPop(&g_rb, &byte) == 1 && byte == in[i]);
+    }
+    TEST_CHECK(RingBufferFastPop(&g_rb, &byte) == 0);
+    TEST_CHECK(RingBufferTotalInGet(&g_rb) == RING_SIZE - 1);
+    TEST_CHECK(RingBufferTotalOutGet(&g_rb) == RING_SIZE - 1);
+
+    printf("put and get across the wrap\n");
+    // Every start offset, the copy splits at the end of the buffer
+    for (i = 0; i < RING_SIZE; i++) {
+        TEST_CHECK(RingBufferFastPut(&g_rb, in, 20) == 20);
+        TEST_CHECK(RingBufferFastGet(&g_rb, out, 20) == 20);
+        TEST_CHECK(memcmp(in, out, 20) == 0);
+        TEST_CHECK(RingBufferFastPut(&g_rb, in, 1) == 1);
+        TEST_CHECK(RingBufferFastGet(&g_rb, out, 1) == 1);
+    }
+    TEST_CHECK(RingBufferFastPut(&g_rb, in, sizeof(in)) == RING_SIZE - 1);
+    TEST_CHECK(RingBufferFastPut(&g_rb, in, 1) == 0);
+    TEST_CHECK(RingBufferFastGet(&g_rb, out, sizeof(out)) == RING_SIZE - 1);
+    TEST_CHECK(memcmp(in, out, RING_SIZE - 1) == 0);
+    TEST_CHECK(RingBufferFastGet(&g_rb, out, 1) == 0);
+
+    printf("mixed with the checked calls\n");
+    for (i = 0; i < RING_SIZE; i++) {
+        TEST_CHECK(RingBufferPut(&g_rb, in, 7) == 7);
+        TEST_CHECK(RingBufferFastPut(&g_rb, &in[7], 5) == 5);
+        TEST_CHECK(RingBufferFastGet(&g_rb, out, 3) == 3);
+        TEST_CHECK(RingBufferGet(&g_rb, &out[3], 9) == 9);
+        TEST_CHECK(memcmp(in, out, 12) == 0);
+    }
+    TEST_CHECK(RingBufferLenGet(&g_rb) == 0);
+    TEST_CHECK(RingBufferTotalInGet(&g_rb) == RingBufferTotalOutGet(&g_rb));
+
+    printf("threaded\n");
+    TEST_CHECK(pthread_create(&thread, NULL, Producer, NULL) == 0);
+    for (j = 0; j < THREAD_BYTES; ) {
+        if (RingBufferFastPop(&g_rb, &byte)) {
+            if (byte != (uint8_t)j) {
+                g_errors++;
+                break;
+            }
+            j++;
+        } else {
+            sched_yield();
+        }
+    }
+    pthread_join(thread, NULL);
+    TEST_CHECK(j == THREAD_BYTES);
+    TEST_CHECK(RingBufferFastLenGet(&g_rb) == 0);
+
+    TEST_CHECK(RingBufferDelete(&g_rb) == RB_OK);
+
+    if (g_errors == 0) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED! (%d errors)\n", g_errors);
+    return 1;
+}
@@ -0,0 +1,161 @@
+#include "../../src/RingBufferFile.h"
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// Test parameters
+#define TEST_FILE       "/tmp/ringbuffer_file_test.bin"
+#define RING_SIZE       (4096)
+
+static int g_errors = 0;
+
+#define TEST_CHECK(cond)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond);     \
+            g_errors++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static uint8_t g_data[RING_SIZE];
+static uint8_t g_read[RING_SIZE];
+
+// Drop the mapping without RingBufferFileClose, like a process that died
+static void crash(RingBufferFile *rbf)
+{
+    munmap(rbf->hdr, (size_t)rbf->mapSize);
+    close(rbf->fd);
+    RingBufferDeinit(&rbf->rb);
+    memset(rbf, 0, sizeof(*rbf));
+}
+
+static void patchHeader(size_t offset, const void *val, size_t len)
+{
+    int fd = open(TEST_FILE, O_RDWR);
+
+    if (fd < 0 || pwrite(fd, val, len, (off_t)offset) != (ssize_t)len) {
+        printf("  patch header failed\n");
+        g_errors++;
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+// Opens the test file, checks how it was recovered and how much is queued
+static int reopen(RingBufferFile *rbf, RingBufferFileRecovery expect, uint32_t len)
+{
+    RingBufferFileRecovery recovery;
+    int status;
+
+    status = RingBufferFileOpen(rbf, TEST_FILE, 0, &recovery);
+    TEST_CHECK(status == RB_OK);
+    if (status) {
+        return status;
+    }
+    TEST_CHECK(recovery == expect);
+    TEST_CHECK(RingBufferLenGet(&rbf->rb) == len);
+
+    return RB_OK;
+}
+
+int main()
+{
+    RingBufferFile rbf;
+    RingBufferFileRecovery recovery;
+    uint32_t bad;
+    uint32_t i;
+
+    for (i = 0; i < RING_SIZE; i++) {
+        g_data[i] = (uint8_t)(i * 7 + 3);
+    }
+    unlink(TEST_FILE);
+
+    printf("new file\n");
+    TEST_CHECK(RingBufferFileOpen(&rbf, TEST_FILE, RING_SIZE, &recovery) == RB_OK);
+    TEST_CHECK(recovery == RINGBUFFER_FILE_NEW);
+
+    printf("crash after a sync: back to the checkpoint\n");
+    TEST_CHECK(RingBufferFilePut(&rbf, g_data, 1000) == 1000);
+    TEST_CHECK(RingBufferFileSync(&rbf) == RB_OK);
+    TEST_CHECK(RingBufferFilePut(&rbf, &g_data[1000], 500) == 500);
+    TEST_CHECK(RingBufferFileGet(&rbf, g_read, 100) == 100);
+    crash(&rbf);
+    if (reopen(&rbf, RINGBUFFER_FILE_CHECKPOINT, 1000) == RB_OK) {
+        // The consumed bytes come again, the unsynced ones are gone
+        TEST_CHECK(RingBufferFileGet(&rbf, g_read, RING_SIZE) == 1000);
+        TEST_CHECK(memcmp(g_read, g_data, 1000) == 0);
+    }
+
+    printf("clean close: live indices\n");
+    TEST_CHECK(RingBufferFilePut(&rbf, g_data, 300) == 300);
+    TEST_CHECK(RingBufferFileClose(&rbf) == RB_OK);
+    if (reopen(&rbf, RINGBUFFER_FILE_CLEAN, 300) == RB_OK) {
+        TEST_CHECK(RingBufferFileGet(&rbf, g_read, 100) == 100);
+        TEST_CHECK(memcmp(g_read, g_data, 100) == 0);
+        TEST_CHECK(RingBufferFileClose(&rbf) == RB_OK);
+    }
+
+    printf("clean close, corrupt live indices: back to the checkpoint\n");
+    bad = RING_SIZE + 1;
+    patchHeader(offsetof(RingBufferFileHeader, tail), &bad, sizeof(bad));
+    if (reopen(&rbf, RINGBUFFER_FILE_CHECKPOINT, 200) == RB_OK) {
+        TEST_CHECK(RingBufferFileGet(&rbf, g_read, RING_SIZE) == 200);
+        TEST_CHECK(memcmp(g_read, &g_data[100], 200) == 0);
+    }
+
+    printf("crash with a corrupt checkpoint: reset\n");
+    TEST_CHECK(RingBufferFilePut(&rbf, g_data, 700) == 700);
+    TEST_CHECK(RingBufferFileSync(&rbf) == RB_OK);
+    rbf.hdr->checkpoint.checksum ^= 0x1U;
+    crash(&rbf);
+    if (reopen(&rbf, RINGBUFFER_FILE_RESET, 0) == RB_OK) {
+        TEST_CHECK(RingBufferFileClose(&rbf) == RB_OK);
+    }
+
+    printf("crash after reusing got space: checkpointed data intact\n");
+    unlink(TEST_FILE);
+    TEST_CHECK(RingBufferFileOpen(&rbf, TEST_FILE, 16, &recovery) == RB_OK);
+    memset(g_read, 'A', 10);
+    TEST_CHECK(RingBufferFilePut(&rbf, g_read, 10) == 10);
+    TEST_CHECK(RingBufferFileSync(&rbf) == RB_OK);
+    TEST_CHECK(RingBufferFileGet(&rbf, g_read, 10) == 10);
+    memset(g_read, 'B', 12);
+    TEST_CHECK(RingBufferFilePut(&rbf, g_read, 12) == 12);
+    crash(&rbf);
+    // The put had to checkpoint the get first, so nothing is delivered twice
+    if (reopen(&rbf, RINGBUFFER_FILE_CHECKPOINT, 0) == RB_OK) {
+        memset(g_read, 'A', 10);
+        TEST_CHECK(RingBufferFilePut(&rbf, g_read, 10) == 10);
+        TEST_CHECK(RingBufferFileSync(&rbf) == RB_OK);
+        TEST_CHECK(RingBufferFileGet(&rbf, g_read, 10) == 10);
+        memset(g_read, 'B', 12);
+        // Only what fits in front of the checkpointed head goes in without a sync
+        TEST_CHECK(RingBufferFilePut(&rbf, g_read, 3) == 3);
+        crash(&rbf);
+    }
+    if (reopen(&rbf, RINGBUFFER_FILE_CHECKPOINT, 10) == RB_OK) {
+        memset(g_read, 0, 10);
+        TEST_CHECK(RingBufferFileGet(&rbf, g_read, RING_SIZE) == 10);
+        TEST_CHECK(memcmp(g_read, "AAAAAAAAAA", 10) == 0);
+        TEST_CHECK(RingBufferFileClose(&rbf) == RB_OK);
+    }
+
+    printf("truncated header: refused\n");
+    TEST_CHECK(truncate(TEST_FILE, 64) == 0);
+    TEST_CHECK(RingBufferFileOpen(&rbf, TEST_FILE, 0, &recovery) == RB_ERROR_INVALID);
+
+    unlink(TEST_FILE);
+
+    if (g_errors == 0) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED! (%d errors)\n", g_errors);
+    return 1;
+}
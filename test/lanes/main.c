@@ -0,0 +1,116 @@
+#include "../../src/RingBufferLanes.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+// Test parameters
+#define RING_SIZE       (64)
+
+static int g_errors = 0;
+
+#define TEST_CHECK(cond)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond);     \
+            g_errors++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static uint8_t g_data[RING_SIZE];
+
+int main()
+{
+    RingBuffer ring[4];
+    RingBufferLanes lq;
+    RingBufferLaneStat stat;
+    uint32_t urgent;
+    uint32_t bulkA;
+    uint32_t bulkB;
+    uint32_t picks[3] = { 0 };
+    uint32_t lane;
+    uint8_t byte;
+    uint32_t i;
+
+    for (i = 0; i < 4; i++) {
+        TEST_CHECK(RingBufferCreate(&ring[i], RING_SIZE) == RB_OK);
+    }
+    TEST_CHECK(RingBufferLanesInit(&lq) == RB_OK);
+    TEST_CHECK(RingBufferLanesAdd(&lq, &ring[0], 0, 1, &urgent) == RB_OK);
+    TEST_CHECK(RingBufferLanesAdd(&lq, &ring[1], 1, 3, &bulkA) == RB_OK);
+    TEST_CHECK(RingBufferLanesAdd(&lq, &ring[2], 1, 0, &bulkB) == RB_OK);
+
+    printf("add errors\n");
+    TEST_CHECK(RingBufferLanesAdd(&lq, &ring[0], 0xFFFFFFFFU, 1, &lane) == RB_ERROR_PARAM);
+    TEST_CHECK(RingBufferLanesAdd(&lq, NULL, 0, 1, &lane) == RB_ERROR_PARAM);
+    for (i = 3; i < RINGBUFFER_LANES_MAX; i++) {
+        TEST_CHECK(RingBufferLanesAdd(&lq, &ring[3], 2, 1, &lane) == RB_OK);
+    }
+    TEST_CHECK(RingBufferLanesAdd(&lq, &ring[3], 2, 1, &lane) == RB_ERROR_LOCKED);
+
+    printf("empty lanes\n");
+    TEST_CHECK(RingBufferLanesGet(&lq, &byte, 1, &lane) == 0);
+    TEST_CHECK(RingBufferLanesLenGet(&lq) == 0);
+
+    printf("strict priority first\n");
+    memset(g_data, 'U', sizeof(g_data));
+    TEST_CHECK(RingBufferLanesPut(&lq, urgent, g_data, 4) == 4);
+    memset(g_data, 'A', sizeof(g_data));
+    TEST_CHECK(RingBufferLanesPut(&lq, bulkA, g_data, 40) == 40);
+    memset(g_data, 'B', sizeof(g_data));
+    // A full lane takes what fits and counts the rest as rejected
+    TEST_CHECK(RingBufferLanesPut(&lq, bulkB, g_data, sizeof(g_data)) == RING_SIZE - 1);
+    TEST_CHECK(RingBufferLanesLenGet(&lq) == 4 + 40 + RING_SIZE - 1);
+    for (i = 0; i < 4; i++) {
+        TEST_CHECK(RingBufferLanesGet(&lq, &byte, 1, &lane) == 1);
+        TEST_CHECK(lane == urgent && byte == 'U');
+    }
+
+    printf("weighted round-robin at the same level\n");
+    // bulkA weight 3, bulkB weight 0 counts as 1: AAAB AAAB ...
+    for (i = 0; i < 40; i++) {
+        TEST_CHECK(RingBufferLanesGet(&lq, &byte, 1, &lane) == 1);
+        TEST_CHECK(lane == (i % 4 == 3 ? bulkB : bulkA));
+        TEST_CHECK(byte == (lane == bulkA ? 'A' : 'B'));
+        picks[lane]++;
+    }
+    TEST_CHECK(picks[bulkA] == 30 && picks[bulkB] == 10);
+
+    printf("an urgent put preempts the round\n");
+    memset(g_data, 'U', sizeof(g_data));
+    TEST_CHECK(RingBufferLanesPut(&lq, urgent, g_data, 1) == 1);
+    TEST_CHECK(RingBufferLanesGet(&lq, &byte, 1, &lane) == 1);
+    TEST_CHECK(lane == urgent && byte == 'U');
+
+    printf("an empty lane gives up its share\n");
+    // bulkA has 10 left, bulkB the rest
+    for (i = 0; i < 10 * 4; i++) {
+        TEST_CHECK(RingBufferLanesGet(&lq, &byte, 1, &lane) == 1);
+    }
+    TEST_CHECK(RingBufferLenGet(&ring[bulkA]) == 0);
+    while (RingBufferLanesGet(&lq, &byte, 1, &lane)) {
+        TEST_CHECK(lane == bulkB);
+    }
+    TEST_CHECK(RingBufferLanesLenGet(&lq) == 0);
+
+    printf("stats\n");
+    TEST_CHECK(RingBufferLanesStatGet(&lq, bulkB, &stat) == RB_OK);
+    TEST_CHECK(stat.putBytes == RING_SIZE - 1);
+    TEST_CHECK(stat.rejectedBytes == 1);
+    TEST_CHECK(stat.getBytes == RING_SIZE - 1 && stat.picks == RING_SIZE - 1);
+    TEST_CHECK(stat.maxLen == RING_SIZE - 1);
+    TEST_CHECK(RingBufferLanesStatGet(&lq, urgent, &stat) == RB_OK);
+    TEST_CHECK(stat.putBytes == 5 && stat.getBytes == 5 && stat.rejectedBytes == 0);
+    TEST_CHECK(RingBufferLanesStatGet(&lq, RINGBUFFER_LANES_MAX, &stat) == RB_ERROR_PARAM);
+
+    for (i = 0; i < 4; i++) {
+        TEST_CHECK(RingBufferDelete(&ring[i]) == RB_OK);
+    }
+
+    if (g_errors == 0) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED! (%d errors)\n", g_errors);
+    return 1;
+}
@@ -0,0 +1,267 @@
+#include "../../src/RingBufferPipeline.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+// Test parameters
+#define RING_SIZE       (64)
+#define RECORDS         (2000)
+#define RECORD_MAX      (40)
+#define FAIL_STATUS     (-100)
+
+static int g_errors = 0;
+
+#define TEST_CHECK(cond)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond);     \
+            g_errors++;                                                     \
+        }                                                                   \
+    } while (0)
+
+typedef struct {
+    uint32_t limit;                     // Records to handle, then DONE
+    uint32_t count;
+    uint32_t bad;
+    uint32_t slowUs;                    // Sleep per call, a slow sink
+    uint32_t failAt;                    // Fail once `count` reaches it, 0 never
+    volatile uint32_t hold;             // Sink blocks in its call while set
+} StageCtx;
+
+/* Records are a length byte then `len` bytes counting up from the index */
+static uint32_t RecordLen(uint32_t index)
+{
+    return 1 + index * 7 % RECORD_MAX;
+}
+
+static uint8_t InByte(const RingBufferStageIo *io, uint32_t off)
+{
+    return off < io->inLen ? io->in[off] : io->in2[off - io->inLen];
+}
+
+static void OutByte(RingBufferStageIo *io, uint32_t off, uint8_t b)
+{
+    if (off < io->outCap) {
+        io->out[off] = b;
+    } else {
+        io->out2[off - io->outCap] = b;
+    }
+}
+
+static int Source(void *arg, RingBufferStageIo *io)
+{
+    StageCtx *ctx = (StageCtx *)arg;
+    uint32_t cap = io->outCap + io->outCap2;
+    uint32_t len;
+    uint32_t j;
+
+    while (ctx->count < ctx->limit) {
+        len = RecordLen(ctx->count);
+        if (io->produced + 1 + len > cap) {
+            return RB_OK;
+        }
+        OutByte(io, io->produced, (uint8_t)len);
+        for (j = 0; j < len; j++) {
+            OutByte(io, io->produced + 1 + j, (uint8_t)(ctx->count + j));
+        }
+        io->produced += 1 + len;
+        ctx->count++;
+    }
+
+    return RINGBUFFER_STAGE_DONE;
+}
+
+/* Forwards whole records only, so every one crossing a wrap has to fit */
+static int Copy(void *arg, RingBufferStageIo *io)
+{
+    StageCtx *ctx = (StageCtx *)arg;
+    uint32_t avail = io->inLen + io->inLen2;
+    uint32_t cap = io->outCap + io->outCap2;
+    uint32_t len;
+    uint32_t j;
+
+    while (io->consumed < avail) {
+        len = 1 + InByte(io, io->consumed);
+        if (io->consumed + len > avail || io->produced + len > cap) {
+            break;
+        }
+        for (j = 0; j < len; j++) {
+            OutByte(io, io->produced + j, InByte(io, io->consumed + j));
+        }
+        io->consumed += len;
+        io->produced += len;
+        if (++ctx->count == ctx->failAt) {
+            return FAIL_STATUS;
+        }
+    }
+
+    return RB_OK;
+}
+
+static int Sink(void *arg, RingBufferStageIo *io)
+{
+    StageCtx *ctx = (StageCtx *)arg;
+    uint32_t avail = io->inLen + io->inLen2;
+    uint32_t len;
+    uint32_t j;
+
+    if (ctx->slowUs) {
+        usleep(ctx->slowUs);
+    }
+    while (ctx->hold) {
+        usleep(1000);
+    }
+    while (io->consumed < avail && ctx->count < ctx->limit) {
+        len = InByte(io, io->consumed);
+        if (io->consumed + 1 + len > avail) {
+            break;
+        }
+        if (len != RecordLen(ctx->count)) {
+            ctx->bad++;
+        }
+        for (j = 0; j < len; j++) {
+            if (InByte(io, io->consumed + 1 + j) != (uint8_t)(ctx->count + j)) {
+                ctx->bad++;
+            }
+        }
+        io->consumed += 1 + len;
+        ctx->count++;
+    }
+
+    return ctx->count < ctx->limit ? RB_OK : RINGBUFFER_STAGE_DONE;
+}
+
+static int Build(RingBufferPipeline *pl, StageCtx ctx[3])
+{
+    int status;
+
+    status = RingBufferPipelineInit(pl, 1, 10, 50);
+    if (status == RB_OK) {
+        status = RingBufferPipelineStageAdd(pl, Source, &ctx[0], 0, -1);
+    }
+    if (status == RB_OK) {
+        status = RingBufferPipelineStageAdd(pl, Copy, &ctx[1], RING_SIZE, -1);
+    }
+    if (status == RB_OK) {
+        status = RingBufferPipelineStageAdd(pl, Sink, &ctx[2], RING_SIZE, -1);
+    }
+
+    return status;
+}
+
+static void WaitDone(RingBufferPipeline *pl)
+{
+    uint32_t i;
+
+    for (i = 0; i < pl->count; i++) {
+        while (!pl->stage[i].done) {
+            usleep(1000);
+        }
+    }
+}
+
+int main()
+{
+    RingBufferPipeline pl;
+    RingBufferStageStat stat[3];
+    StageCtx ctx[3];
+    uint64_t bytes = 0;
+    uint32_t i;
+
+    for (i = 0; i < RECORDS; i++) {
+        bytes += 1 + RecordLen(i);
+    }
+
+    printf("setup errors\n");
+    TEST_CHECK(RingBufferPipelineInit(&pl, 0, 0, 0) == RB_ERROR_PARAM);
+    TEST_CHECK(RingBufferPipelineInit(&pl, 1, 0, 0) == RB_OK);
+    TEST_CHECK(RingBufferPipelineStageAdd(&pl, Source, &ctx[0], 0, -1) == RB_OK);
+    TEST_CHECK(RingBufferPipelineStart(&pl) == RB_ERROR_PARAM);
+    TEST_CHECK(RingBufferPipelineStageAdd(&pl, Sink, &ctx[2], 1, -1) == RB_ERROR_PARAM);
+    TEST_CHECK(RingBufferPipelineDeinit(&pl) == RB_OK);
+
+    printf("records across the wrap, slow sink\n");
+    memset(ctx, 0, sizeof(ctx));
+    ctx[0].limit = RECORDS;
+    ctx[2].limit = RECORDS;
+    ctx[2].slowUs = 20;
+    TEST_CHECK(Build(&pl, ctx) == RB_OK);
+    TEST_CHECK(RingBufferPipelineStart(&pl) == RB_OK);
+    TEST_CHECK(RingBufferPipelineWait(&pl) == RB_OK);
+    TEST_CHECK(ctx[1].count == RECORDS);
+    TEST_CHECK(ctx[2].count == RECORDS && ctx[2].bad == 0);
+    for (i = 0; i < 3; i++) {
+        TEST_CHECK(RingBufferPipelineStatGet(&pl, i, &stat[i]) == RB_OK);
+        TEST_CHECK(stat[i].status == RB_OK);
+    }
+    TEST_CHECK(stat[0].bytesOut == bytes && stat[1].bytesIn == bytes);
+    TEST_CHECK(stat[1].bytesOut == bytes && stat[2].bytesIn == bytes);
+    // The sink sets the pace, the stages before it wait for space
+    TEST_CHECK(stat[0].blockedTimes > 0 && stat[0].blockedNs > 0);
+    TEST_CHECK(stat[0].starvedTimes == 0);
+    TEST_CHECK(stat[2].blockedTimes == 0);
+    TEST_CHECK(RingBufferPipelineStatGet(&pl, 3, &stat[0]) == RB_ERROR_PARAM);
+    TEST_CHECK(RingBufferPipelineDeinit(&pl) == RB_OK);
+
+    printf("sink done shuts the pipeline down\n");
+    memset(ctx, 0, sizeof(ctx));
+    ctx[0].limit = 0xFFFFFFFFU;
+    ctx[2].limit = 10;
+    TEST_CHECK(Build(&pl, ctx) == RB_OK);
+    TEST_CHECK(RingBufferPipelineStart(&pl) == RB_OK);
+    TEST_CHECK(RingBufferPipelineWait(&pl) == RB_OK);
+    TEST_CHECK(ctx[2].count == 10 && ctx[2].bad == 0);
+    TEST_CHECK(pl.stage[0].done && pl.stage[1].done && pl.stage[2].done);
+    TEST_CHECK(RingBufferPipelineDeinit(&pl) == RB_OK);
+
+    printf("stop\n");
+    memset(ctx, 0, sizeof(ctx));
+    ctx[0].limit = 0xFFFFFFFFU;
+    ctx[2].limit = 0xFFFFFFFFU;
+    TEST_CHECK(Build(&pl, ctx) == RB_OK);
+    TEST_CHECK(RingBufferPipelineStart(&pl) == RB_OK);
+    usleep(10000);
+    TEST_CHECK(RingBufferPipelineStop(&pl) == RB_OK);
+    TEST_CHECK(RingBufferPipelineWait(&pl) == RB_OK);
+    TEST_CHECK(ctx[2].bad == 0);
+    TEST_CHECK(RingBufferPipelineDeinit(&pl) == RB_OK);
+
+    printf("stage error stops every stage\n");
+    memset(ctx, 0, sizeof(ctx));
+    ctx[0].limit = 0xFFFFFFFFU;
+    ctx[1].failAt = 100;
+    ctx[2].limit = 0xFFFFFFFFU;
+    TEST_CHECK(Build(&pl, ctx) == RB_OK);
+    TEST_CHECK(RingBufferPipelineStart(&pl) == RB_OK);
+    TEST_CHECK(RingBufferPipelineWait(&pl) == FAIL_STATUS);
+    TEST_CHECK(RingBufferPipelineStatGet(&pl, 1, &stat[1]) == RB_OK);
+    TEST_CHECK(stat[1].status == FAIL_STATUS);
+    TEST_CHECK(ctx[2].count < 100 && ctx[2].bad == 0);
+    TEST_CHECK(RingBufferPipelineDeinit(&pl) == RB_OK);
+
+    printf("deinit while running, then without wait\n");
+    memset(ctx, 0, sizeof(ctx));
+    ctx[0].limit = RECORDS;
+    ctx[2].limit = RECORDS;
+    ctx[2].hold = 1;
+    TEST_CHECK(Build(&pl, ctx) == RB_OK);
+    TEST_CHECK(RingBufferPipelineStart(&pl) == RB_OK);
+    usleep(10000);
+    TEST_CHECK(RingBufferPipelineDeinit(&pl) == RB_ERROR_LOCKED);
+    // Both rings are full behind the held sink
+    TEST_CHECK(RingBufferLenGet(&pl.ring[1]) > RING_SIZE - 1 - 1 - RECORD_MAX);
+    ctx[2].hold = 0;
+    WaitDone(&pl);
+    TEST_CHECK(ctx[2].count == RECORDS && ctx[2].bad == 0);
+    TEST_CHECK(RingBufferPipelineDeinit(&pl) == RB_OK);
+    TEST_CHECK(pl.count == 0);
+
+    if (g_errors == 0) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED! (%d errors)\n", g_errors);
+    return 1;
+}
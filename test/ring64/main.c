@@ -0,0 +1,112 @@
+#include "../../src/RingBuffer64.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+// Test parameters
+#define RING_SIZE       (13)            // Not a power of two, so every modulo is exercised
+#define START_POS       (0xFFFFFFFFULL - 100)
+#define TEST_LOOP       (1000)
+
+static int g_errors = 0;
+
+#define TEST_CHECK(cond)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond);     \
+            g_errors++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static uint8_t g_mem[RING_SIZE];
+
+// Byte at stream position `pos`, so data checks hold across any wrap
+static uint8_t pattern(uint64_t pos)
+{
+    return (uint8_t)(pos * 7 + (pos >> 32));
+}
+
+static void fill(uint8_t *data, uint64_t pos, uint64_t size)
+{
+    for (uint64_t i = 0; i < size; i++) {
+        data[i] = pattern(pos + i);
+    }
+}
+
+static int check(const uint8_t *data, uint64_t pos, uint64_t size)
+{
+    for (uint64_t i = 0; i < size; i++) {
+        if (data[i] != pattern(pos + i)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Empty ring whose stream positions start at `pos`
+static void start(RingBuffer64 *rb, uint64_t pos)
+{
+    TEST_CHECK(RingBuffer64Init(rb, g_mem, sizeof(g_mem)) == RB_OK);
+    rb->head = pos;
+    rb->tail = pos;
+}
+
+int main()
+{
+    RingBuffer64 rb;
+    uint8_t data[RING_SIZE * 2];
+    uint64_t in;
+    uint64_t out;
+    uint64_t len;
+    uint32_t i;
+
+    printf("full capacity across 2^32\n");
+    start(&rb, 0x100000000ULL - 5);
+    fill(data, rb.tail, sizeof(data));
+    TEST_CHECK(RingBuffer64Put(&rb, data, sizeof(data)) == RING_SIZE);
+    TEST_CHECK(RingBuffer64LenGet(&rb) == RING_SIZE);
+    TEST_CHECK(RingBuffer64Put(&rb, data, 1) == 0);
+    TEST_CHECK(RingBuffer64TotalInGet(&rb) == 0x100000000ULL - 5 + RING_SIZE);
+    memset(data, 0, sizeof(data));
+    TEST_CHECK(RingBuffer64Get(&rb, data, sizeof(data)) == RING_SIZE);
+    TEST_CHECK(check(data, 0x100000000ULL - 5, RING_SIZE));
+    TEST_CHECK(RingBuffer64LenGet(&rb) == 0);
+    TEST_CHECK(RingBuffer64Get(&rb, data, 1) == 0);
+    TEST_CHECK(RingBuffer64TotalOutGet(&rb) == RingBuffer64TotalInGet(&rb));
+
+    printf("streaming past UINT32_MAX\n");
+    start(&rb, START_POS);
+    in = START_POS;
+    out = START_POS;
+    for (i = 0; i < TEST_LOOP; i++) {
+        fill(data, in, i % 17);
+        len = RingBuffer64Put(&rb, data, i % 17);
+        TEST_CHECK(len == (i % 17 < RING_SIZE - (in - out) ? i % 17 : RING_SIZE - (in - out)));
+        in += len;
+        TEST_CHECK(RingBuffer64LenGet(&rb) == in - out);
+
+        len = RingBuffer64Get(&rb, data, i % 11);
+        TEST_CHECK(check(data, out, len));
+        out += len;
+        TEST_CHECK(RingBuffer64LenGet(&rb) == in - out);
+        TEST_CHECK(RingBuffer64LenGet(&rb) <= RING_SIZE);
+    }
+    TEST_CHECK(out > 0xFFFFFFFFULL);
+    TEST_CHECK(RingBuffer64TotalInGet(&rb) == in);
+    TEST_CHECK(RingBuffer64TotalOutGet(&rb) == out);
+
+    printf("refused arguments\n");
+    TEST_CHECK(RingBuffer64Init(&rb, g_mem, 0) == RB_ERROR_PARAM);
+    TEST_CHECK(RingBuffer64Init(&rb, NULL, sizeof(g_mem)) == RB_ERROR_PARAM);
+    TEST_CHECK(RingBuffer64Deinit(&rb) == RB_OK);
+    TEST_CHECK(RingBuffer64Put(&rb, data, 1) == 0);
+    TEST_CHECK(RingBuffer64LenGet(&rb) == 0);
+
+    if (g_errors == 0) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED! (%d errors)\n", g_errors);
+    return 1;
+}
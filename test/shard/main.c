@@ -0,0 +1,170 @@
+#include "../../src/RingBufferShard.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+// Test parameters
+#define SHARDS          (4)
+#define SHARD_SIZE      (256)
+#define THREAD_BYTES    (200000)
+#define CHUNK           (37)
+
+static int g_errors = 0;
+
+#define TEST_CHECK(cond)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond);     \
+            g_errors++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static RingBufferShardSet g_set;
+
+/* Each producer writes a byte count-up on its own shard */
+static void *Producer(void *arg)
+{
+    RingBufferShardProducer prod;
+    uint8_t chunk[CHUNK];
+    uint32_t sent = 0;
+    uint32_t n;
+    uint32_t i;
+
+    (void)arg;
+    if (RingBufferShardProducerAttach(&g_set, &prod) != RB_OK) {
+        g_errors++;
+        return NULL;
+    }
+    while (sent < THREAD_BYTES) {
+        n = THREAD_BYTES - sent < CHUNK ? THREAD_BYTES - sent : CHUNK;
+        for (i = 0; i < n; i++) {
+            chunk[i] = (uint8_t)(sent + i);
+        }
+        n = RingBufferShardPut(&prod, chunk, n);
+        sent += n;
+        if (n == 0) {
+            sched_yield();
+        }
+    }
+    RingBufferShardProducerDetach(&prod);
+
+    return NULL;
+}
+
+static uint32_t Fill(RingBufferShardProducer *prod, uint32_t len)
+{
+    uint8_t data[SHARD_SIZE];
+
+    memset(data, (int)prod->id, sizeof(data));
+    return RingBufferShardPut(prod, data, len);
+}
+
+int main()
+{
+    RingBufferShardProducer prod[SHARDS + 1];
+    pthread_t thread[SHARDS];
+    uint32_t received[SHARDS] = { 0 };
+    uint32_t expect[SHARDS] = { 0 };
+    uint8_t data[SHARD_SIZE];
+    uint64_t total = 0;
+    uint32_t shard;
+    uint32_t len;
+    uint32_t i;
+
+    printf("create and attach\n");
+    TEST_CHECK(RingBufferShardSetCreate(&g_set, SHARDS, 1, RINGBUFFER_SHARD_ROUND_ROBIN) == RB_ERROR_PARAM);
+    TEST_CHECK(RingBufferShardSetCreate(&g_set, RINGBUFFER_SHARD_MAX + 1, SHARD_SIZE, RINGBUFFER_SHARD_ROUND_ROBIN) == RB_ERROR_PARAM);
+    TEST_CHECK(RingBufferShardSetCreate(&g_set, SHARDS, SHARD_SIZE, RINGBUFFER_SHARD_ROUND_ROBIN) == RB_OK);
+    for (i = 0; i < SHARDS; i++) {
+        TEST_CHECK(RingBufferShardProducerAttach(&g_set, &prod[i]) == RB_OK);
+    }
+    // Every producer owns a shard of its own
+    for (i = 1; i < SHARDS; i++) {
+        TEST_CHECK(prod[i].id != prod[0].id && prod[i].id != prod[i - 1].id);
+    }
+    TEST_CHECK(RingBufferShardProducerAttach(&g_set, &prod[SHARDS]) == RB_ERROR_LOCKED);
+
+    printf("round robin\n");
+    TEST_CHECK(RingBufferShardGet(&g_set, data, sizeof(data), &shard) == 0);
+    for (i = 0; i < SHARDS; i++) {
+        TEST_CHECK(Fill(&prod[i], 20) == 20);
+    }
+    TEST_CHECK(RingBufferShardLenGet(&g_set) == SHARDS * 20);
+    for (i = 0; i < SHARDS * 2; i++) {
+        TEST_CHECK(RingBufferShardGet(&g_set, data, 10, &shard) == 10);
+        TEST_CHECK(shard == i % SHARDS);
+        // A batch comes from a single shard
+        TEST_CHECK(data[0] == shard && data[9] == shard);
+    }
+    TEST_CHECK(RingBufferShardLenGet(&g_set) == 0);
+
+    printf("detach frees the shard\n");
+    shard = prod[1].id;
+    TEST_CHECK(RingBufferShardProducerDetach(&prod[1]) == RB_OK);
+    TEST_CHECK(RingBufferShardPut(&prod[1], data, 1) == 0);
+    TEST_CHECK(RingBufferShardProducerAttach(&g_set, &prod[SHARDS]) == RB_OK);
+    TEST_CHECK(prod[SHARDS].id == shard);
+    TEST_CHECK(RingBufferShardProducerDetach(&prod[SHARDS]) == RB_OK);
+    for (i = 0; i < SHARDS; i++) {
+        if (i != 1) {
+            TEST_CHECK(RingBufferShardProducerDetach(&prod[i]) == RB_OK);
+        }
+    }
+    TEST_CHECK(RingBufferShardSetDelete(&g_set) == RB_OK);
+
+    printf("occupancy\n");
+    TEST_CHECK(RingBufferShardSetCreate(&g_set, SHARDS, SHARD_SIZE, RINGBUFFER_SHARD_OCCUPANCY) == RB_OK);
+    for (i = 0; i < SHARDS; i++) {
+        TEST_CHECK(RingBufferShardProducerAttach(&g_set, &prod[i]) == RB_OK);
+        TEST_CHECK(Fill(&prod[i], 10 * (prod[i].id + 1)) == 10 * (prod[i].id + 1));
+    }
+    // Fullest first, a tie goes to the first shard after the last one read
+    TEST_CHECK(RingBufferShardGet(&g_set, data, 10, &shard) == 10 && shard == 3);
+    TEST_CHECK(RingBufferShardGet(&g_set, data, 10, &shard) == 10 && shard == 2);
+    TEST_CHECK(RingBufferShardGet(&g_set, data, 10, &shard) == 10 && shard == 3);
+    for (i = 0; i < SHARDS; i++) {
+        TEST_CHECK(RingBufferShardProducerDetach(&prod[i]) == RB_OK);
+    }
+    while (RingBufferShardGet(&g_set, data, sizeof(data), &shard)) {
+    }
+    TEST_CHECK(RingBufferShardSetDelete(&g_set) == RB_OK);
+
+    printf("threaded producers\n");
+    TEST_CHECK(RingBufferShardSetCreate(&g_set, SHARDS, SHARD_SIZE, RINGBUFFER_SHARD_ROUND_ROBIN) == RB_OK);
+    for (i = 0; i < SHARDS; i++) {
+        TEST_CHECK(pthread_create(&thread[i], NULL, Producer, NULL) == 0);
+    }
+    while (total < (uint64_t)SHARDS * THREAD_BYTES) {
+        len = RingBufferShardGet(&g_set, data, sizeof(data), &shard);
+        if (len == 0) {
+            sched_yield();
+            continue;
+        }
+        // Every shard carries one producer's stream in order
+        for (i = 0; i < len; i++) {
+            if (data[i] != (uint8_t)expect[shard]++) {
+                g_errors++;
+                break;
+            }
+        }
+        received[shard] += len;
+        total += len;
+    }
+    for (i = 0; i < SHARDS; i++) {
+        pthread_join(thread[i], NULL);
+        TEST_CHECK(received[i] == THREAD_BYTES);
+    }
+    TEST_CHECK(RingBufferShardLenGet(&g_set) == 0);
+    TEST_CHECK(RingBufferShardSetDelete(&g_set) == RB_OK);
+    TEST_CHECK(RingBufferShardSetDelete(&g_set) == RB_ERROR_PARAM);
+
+    if (g_errors == 0) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED! (%d errors)\n", g_errors);
+    return 1;
+}
@@ -0,0 +1,148 @@
+#include "../../src/RingBuffer.h"
+#include "../../src/RingBufferShm.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+// Test parameters
+#define TOTAL_DATA_SIZE (1ULL * 1024 * 1024 * 1024)  // 1GB
+#define BUFFER_SIZE     (1 * 1024 * 1024)            // 1MB buffer
+#define WAIT_SIZE       (16 * 1024)                  // Producer sleeps until this much space is free
+#define WAIT_TIMEOUT_MS (1000)
+
+static double now_sec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Producer process: writes a counting pattern straight into the shared ring
+static int producer(RingBufferShm *shm)
+{
+    uint64_t produced = 0;
+    uint8_t *data;
+    uint32_t len;
+
+    while (produced < TOTAL_DATA_SIZE) {
+        len = RingBufferShmWriteAcquire(shm, &data);
+        if (len == 0) {
+            RingBufferShmWaitSpace(shm, WAIT_SIZE, WAIT_TIMEOUT_MS);
+            continue;
+        }
+        if (len > TOTAL_DATA_SIZE - produced) {
+            len = (uint32_t)(TOTAL_DATA_SIZE - produced);
+        }
+        for (uint32_t i = 0; i < len; i++) {
+            data[i] = (uint8_t)(produced + i);
+        }
+        RingBufferShmWriteCommit(shm, len);
+        produced += len;
+    }
+
+    printf("Producer: Finished, total produced %llu bytes\n", (unsigned long long)produced);
+    return 0;
+}
+
+// Consumer process: joins through the inherited fd and checks in place
+static int consumer(int fd)
+{
+    RingBufferShm shm;
+    const uint8_t *data;
+    uint64_t consumed = 0;
+    uint64_t errors = 0;
+    uint32_t len;
+    int result;
+
+    result = RingBufferShmAttachFd(&shm, fd);
+    if (result != RB_OK) {
+        printf("Consumer: Failed to attach: %d\n", result);
+        return 1;
+    }
+
+    while (consumed < TOTAL_DATA_SIZE) {
+        len = RingBufferShmReadAcquire(&shm, &data);
+        if (len == 0) {
+            if (RingBufferShmWaitData(&shm, 0, WAIT_TIMEOUT_MS) != RB_OK) {
+                printf("Consumer: Timed out at %llu bytes\n", (unsigned long long)consumed);
+                break;
+            }
+            continue;
+        }
+        for (uint32_t i = 0; i < len; i++) {
+            if (data[i] != (uint8_t)(consumed + i)) {
+                errors++;
+            }
+        }
+        RingBufferShmReadRelease(&shm, len);
+        consumed += len;
+    }
+
+    printf("Consumer: Finished, total consumed %llu bytes\n", (unsigned long long)consumed);
+    printf("Verification errors: %llu\n", (unsigned long long)errors);
+
+    RingBufferShmDetach(&shm);
+
+    return (errors == 0 && consumed == TOTAL_DATA_SIZE) ? 0 : 1;
+}
+
+int main(void)
+{
+    RingBufferShm shm;
+    double start;
+    double elapsed;
+    int status;
+    pid_t pid;
+
+    printf("Shared Memory Ring Buffer Test Program\n");
+    printf("Test size: %llu bytes\n", TOTAL_DATA_SIZE);
+    printf("Buffer size: %u bytes\n", BUFFER_SIZE);
+    printf("\n");
+
+    int result = RingBufferShmCreate(&shm, NULL, BUFFER_SIZE);
+    if (result != RB_OK) {
+        printf("Failed to create shared ring buffer: %d\n", result);
+        return 1;
+    }
+
+    fflush(stdout);
+    start = now_sec();
+    pid = fork();
+    if (pid < 0) {
+        printf("Failed to fork\n");
+        return 1;
+    }
+    if (pid == 0) {
+        // Drop the parent's mapping, the consumer maps the object again at its own address
+        int fd = dup(RingBufferShmFdGet(&shm));
+        RingBufferShmDetach(&shm);
+        result = consumer(fd);
+        close(fd);
+        fflush(stdout);
+        _exit(result);
+    }
+
+    producer(&shm);
+    waitpid(pid, &status, 0);
+    elapsed = now_sec() - start;
+
+    printf("ring buffer total in %llu\n", (unsigned long long)RingBufferShmTotalInGet(&shm));
+    printf("ring buffer total out %llu\n", (unsigned long long)RingBufferShmTotalOutGet(&shm));
+    RingBufferShmDetach(&shm);
+
+    printf("\n=== Final Results ===\n");
+    printf("Total time: %.3f seconds\n", elapsed);
+    printf("Throughput: %.2f MB/s\n", TOTAL_DATA_SIZE / elapsed / (1024 * 1024));
+
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED!\n");
+    return 1;
+}
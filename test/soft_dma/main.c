@@ -0,0 +1,335 @@
+#include "../../src/RingBuffer.h"
+#include "../../src/RingBufferSoftDMA.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+// Test parameters
+#define TOTAL_DATA_SIZE (1ULL * 1024 * 1024 * 1024)  // 1GB
+#define BUFFER_SIZE     (1 * 1024 * 1024)            // 1MB buffer
+#define CHUNK_SIZE      (64 * 1024)                  // 64KB dma block
+#define DMA_BANDWIDTH   (0)                          // Bytes per second, 0 = unlimited
+#define DMA_BURST       (4 * 1024)                   // Bytes moved between length updates
+#define DMA_IRQ_DELAY   (20 * 1000)                  // Ns from chaining to the completion irq
+
+// Circular mode parameters
+#define CIRC_SIZE       (8 * 1024)                   // Ring and source buffer
+#define CIRC_BANDWIDTH  (1024 * 1024)                // 8 ms a lap
+#define CIRC_BURST      (128)
+#define CIRC_IRQ_DELAY  (1000 * 1000)                // The reader runs well past HT/TC before they fire
+#define CIRC_LAPS       (50)
+static uint8_t RAND;
+
+// Global variables
+static RingBuffer g_rb;
+static pthread_t g_producerThread;
+static pthread_t g_consumerThread;
+
+static volatile uint64_t g_totalProduced = 0;
+static volatile uint64_t g_totalConsumed = 0;
+static volatile uint32_t g_errors = 0;
+static volatile uint32_t g_tailBack = 0;
+
+static void printInfo(RingBuffer *rb, const char *tag)
+{
+    RingBufferStatistics stat;
+
+    if (tag != NULL) {
+        printf("%s:\n", tag);
+    } else {
+        printf("(no name)\n");
+    }
+    printf("ring buffer len %u\n", RingBufferLenGet(rb));
+    printf("ring buffer size %u\n", RingBufferSizeGet(rb));
+    printf("ring buffer total in %llu\n", (unsigned long long)RingBufferTotalInGet(rb));
+    printf("ring buffer total out %llu\n", (unsigned long long)RingBufferTotalOutGet(rb));
+    printf("overflowTimes = %llu\n", (unsigned long long)RingBufferOverflowTimesGet(rb));
+
+    if (RingBufferStatisticsGet(rb, &stat) == RB_OK) {
+        printf("high water mark %u\n", stat.highWaterMark);
+        printf("dma blocks %llu, get calls %llu, empty %llu\n",
+               (unsigned long long)stat.putCalls, (unsigned long long)stat.getCalls,
+               (unsigned long long)stat.emptyTimes);
+    }
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Generate test data chunk
+static void generate_test_data(uint8_t *data, uint32_t size, uint32_t pattern) {
+    for (uint32_t i = 0; i < size; i++) {
+        data[i] = (uint8_t)((pattern + i + RAND) & 0xFF);
+    }
+}
+
+// Verify data
+static bool verify_data(const uint8_t *data, uint32_t size, uint32_t expected_pattern) {
+    for (uint32_t i = 0; i < size; i++) {
+        uint8_t expected = (uint8_t)((expected_pattern + i + RAND) & 0xFF);
+        if (data[i] != expected) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Producer thread, plays the driver that feeds the dma engine.
+// Keeps RINGBUFFER_DMA_QUEUE_DEPTH blocks queued so the engine never idles.
+static void *producer_thread(void *arg) {
+    int status;
+    uint8_t *data_buffer[RINGBUFFER_DMA_QUEUE_DEPTH];
+    uint64_t issued = 0;
+    uint64_t completed = 0;
+    uint32_t local_pattern = 0;
+    uint32_t inflight;
+
+    (void)arg;
+
+    for (uint32_t i = 0; i < RINGBUFFER_DMA_QUEUE_DEPTH; i++) {
+        data_buffer[i] = (uint8_t *)malloc(CHUNK_SIZE);
+        if (!data_buffer[i]) {
+            printf("Producer: Failed to allocate memory\n");
+            return NULL;
+        }
+    }
+
+    while (completed < TOTAL_DATA_SIZE / CHUNK_SIZE) {
+        completed = RingBufferTotalInGet(&g_rb) / CHUNK_SIZE;
+        __atomic_store_n(&g_totalProduced, completed * CHUNK_SIZE, __ATOMIC_RELEASE);
+
+        inflight = (uint32_t)(issued - completed);
+        if (issued * CHUNK_SIZE >= TOTAL_DATA_SIZE || inflight >= RINGBUFFER_DMA_QUEUE_DEPTH ||
+            RingBufferSizeGet(&g_rb) - RingBufferLenGet(&g_rb) - 1 < (inflight + 1) * CHUNK_SIZE) {
+            sched_yield();
+            continue;
+        }
+
+        // The buffer of a retired block is free again
+        generate_test_data(data_buffer[issued % RINGBUFFER_DMA_QUEUE_DEPTH], CHUNK_SIZE, local_pattern);
+
+        status = RingBufferDMAEnqueue(&g_rb, (RB_ADDRESS)(uintptr_t)data_buffer[issued % RINGBUFFER_DMA_QUEUE_DEPTH], CHUNK_SIZE);
+        if (status == RB_ERROR_LOCKED) {
+            sched_yield();
+            continue;
+        } else if (status) {
+            printf("Producer: Enqueue dma fail(%d)\n", status);
+            continue;
+        }
+        if (g_rb.dmaState == RINGBUFFER_DMA_READY) {
+            status = RingBufferDMAStart(&g_rb);
+            if (status) {
+                printf("Producer: Start dma fail(%d)\n", status);
+            }
+        }
+
+        issued++;
+        local_pattern += CHUNK_SIZE;
+    }
+
+    for (uint32_t i = 0; i < RINGBUFFER_DMA_QUEUE_DEPTH; i++) {
+        free(data_buffer[i]);
+    }
+
+    printf("Producer: Finished, total produced %llu bytes\n", (unsigned long long)g_totalProduced);
+
+    return NULL;
+}
+
+// Consumer thread
+static void *consumer_thread(void *arg) {
+    uint8_t *data_buffer;
+    uint64_t local_consumed = 0;
+    uint32_t local_pattern = 0;
+    uint32_t local_errors = 0;
+    uint32_t read;
+    uint64_t pos;
+    uint64_t last_pos = 0;
+
+    (void)arg;
+
+    data_buffer = (uint8_t *)malloc(CHUNK_SIZE);
+    if (!data_buffer) {
+        printf("Consumer: Failed to allocate memory\n");
+        return NULL;
+    }
+
+    while (local_consumed < TOTAL_DATA_SIZE) {
+        // Poll the length across chained block boundaries, the tail never goes back
+        pos = local_consumed + RingBufferLenGet(&g_rb);
+        if (pos < last_pos) {
+            g_tailBack++;
+        }
+        last_pos = pos;
+
+        read = RingBufferGet(&g_rb, data_buffer, CHUNK_SIZE);
+        if (read > 0) {
+            if (!verify_data(data_buffer, read, local_pattern)) {
+                local_errors++;
+            }
+            local_consumed += read;
+            local_pattern += read;
+            __atomic_store_n(&g_totalConsumed, local_consumed, __ATOMIC_RELEASE);
+        } else {
+            sched_yield();
+        }
+    }
+
+    free(data_buffer);
+
+    g_errors = local_errors;
+
+    printf("Consumer: Finished, total consumed %llu bytes, found %u errors\n",
+           (unsigned long long)local_consumed, local_errors);
+
+    return NULL;
+}
+
+#if RINGBUFFER_USE_DMA_CIRCULAR
+
+static uint8_t g_circSrc[CIRC_SIZE];
+
+// Reads what is there and checks it against the source at the stream position
+static uint32_t circular_read(RingBuffer *rb, uint8_t *data, uint32_t *errors)
+{
+    uint64_t pos = RingBufferTotalOutGet(rb);
+    uint32_t read = RingBufferGet(rb, data, CIRC_SIZE);
+
+    for (uint32_t i = 0; i < read; i++) {
+        if (data[i] != g_circSrc[(pos + i) % CIRC_SIZE]) {
+            (*errors)++;
+            break;
+        }
+    }
+
+    return read;
+}
+
+// Circular mode: a reader that keeps up sees every byte once, one that does not gets an overflow
+static int circular_test(void)
+{
+    static uint8_t data[CIRC_SIZE];
+    RingBuffer rb;
+    struct timespec lap = { 0, 3 * (CIRC_SIZE * 1000000000LL / CIRC_BANDWIDTH) };
+    uint64_t consumed = 0;
+    uint32_t errors = 0;
+    uint32_t read;
+    int failed = 0;
+
+    for (uint32_t i = 0; i < CIRC_SIZE; i++) {
+        g_circSrc[i] = (uint8_t)(i * 7 + i / 251 + RAND);
+    }
+
+    if (RingBufferCreate(&rb, CIRC_SIZE) != RB_OK ||
+        RingBufferSoftDMACreate(&rb, CIRC_BANDWIDTH, CIRC_BURST, NULL) != RB_OK) {
+        printf("Circular: setup failed\n");
+        return 1;
+    }
+    RingBufferSoftDMAIrqDelaySet(&rb, CIRC_IRQ_DELAY);
+    RingBufferSoftDMACircularSet(&rb, 1);
+
+    // Following the live position between the events must not look like an overrun
+    RingBufferDMACircularStart(&rb, (RB_ADDRESS)(uintptr_t)g_circSrc);
+    while (consumed < (uint64_t)CIRC_LAPS * CIRC_SIZE) {
+        read = circular_read(&rb, data, &errors);
+        consumed += read;
+        if (read == 0) {
+            sched_yield();
+        }
+    }
+    RingBufferDMAStop(&rb);
+    consumed += circular_read(&rb, data, &errors);
+    printf("Circular: consumed %llu, total in %llu, overflow %llu, errors %u\n",
+           (unsigned long long)consumed, (unsigned long long)RingBufferTotalInGet(&rb),
+           (unsigned long long)RingBufferOverflowTimesGet(&rb), errors);
+    if (errors || consumed != RingBufferTotalInGet(&rb) || RingBufferOverflowTimesGet(&rb) != 0) {
+        failed = 1;
+    }
+
+    // Three laps unread: overflow counted, the reader resumes on valid data
+    RingBufferDMACircularStart(&rb, (RB_ADDRESS)(uintptr_t)g_circSrc);
+    nanosleep(&lap, NULL);
+    RingBufferDMAStop(&rb);
+    read = circular_read(&rb, data, &errors);
+    printf("Circular overrun: read %u, overflow %llu, errors %u\n",
+           read, (unsigned long long)RingBufferOverflowTimesGet(&rb), errors);
+    if (errors || read == 0 || read >= CIRC_SIZE || RingBufferOverflowTimesGet(&rb) == 0) {
+        failed = 1;
+    }
+
+    RingBufferSoftDMADelete(&rb);
+    RingBufferDelete(&rb);
+
+    return failed;
+}
+
+#endif  /* RINGBUFFER_USE_DMA_CIRCULAR */
+
+int main() {
+    double start;
+    double elapsed;
+
+    srand(time(NULL));
+    RAND = (uint8_t)rand();
+
+    printf("Soft DMA Ring Buffer Test Program\n");
+    printf("Test size: %llu bytes\n", TOTAL_DATA_SIZE);
+    printf("Buffer size: %u bytes\n", BUFFER_SIZE);
+    printf("Chunk size: %u bytes\n", CHUNK_SIZE);
+    printf("Queue depth: %u blocks\n", RINGBUFFER_DMA_QUEUE_DEPTH);
+    printf("Irq delay: %u ns\n", DMA_IRQ_DELAY);
+    printf("\n");
+
+    int result = RingBufferCreate(&g_rb, BUFFER_SIZE);
+    if (result != RB_OK) {
+        printf("Failed to create ring buffer: %d\n", result);
+        return 1;
+    }
+
+    result = RingBufferSoftDMACreate(&g_rb, DMA_BANDWIDTH, DMA_BURST, NULL);
+    if (result != RB_OK) {
+        printf("Failed to create soft dma engine: %d\n", result);
+        return 1;
+    }
+    RingBufferSoftDMAIrqDelaySet(&g_rb, DMA_IRQ_DELAY);
+
+    start = now_sec();
+    pthread_create(&g_consumerThread, NULL, consumer_thread, NULL);
+    pthread_create(&g_producerThread, NULL, producer_thread, NULL);
+    pthread_join(g_producerThread, NULL);
+    pthread_join(g_consumerThread, NULL);
+    elapsed = now_sec() - start;
+
+    printInfo(&g_rb, "\nafter test");
+
+    RingBufferSoftDMADelete(&g_rb);
+    RingBufferDelete(&g_rb);
+
+    int circularFailed = 0;
+#if RINGBUFFER_USE_DMA_CIRCULAR
+    circularFailed = circular_test();
+#endif
+
+    printf("\n=== Final Results ===\n");
+    printf("Total time: %.3f seconds\n", elapsed);
+    printf("Throughput: %.2f MB/s\n", g_totalConsumed / elapsed / (1024 * 1024));
+    printf("Verification errors: %u\n", g_errors);
+    printf("Tail moved back: %u\n", g_tailBack);
+
+    if (!circularFailed && g_errors == 0 && g_tailBack == 0 && g_totalProduced == TOTAL_DATA_SIZE && g_totalConsumed == TOTAL_DATA_SIZE) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED!\n");
+    return 1;
+}
@@ -0,0 +1,94 @@
+#include "../../src/RingBuffer.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+// Test parameters
+#define RING_SIZE       (16)
+
+static int g_errors = 0;
+
+#define TEST_CHECK(cond)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond);     \
+            g_errors++;                                                     \
+        }                                                                   \
+    } while (0)
+
+int main()
+{
+    RingBuffer rb;
+    RingBufferStatistics stat;
+    uint8_t data[RING_SIZE * 4];
+
+    memset(data, 0x5A, sizeof(data));
+    TEST_CHECK(RingBufferCreate(&rb, RING_SIZE) == RB_OK);
+    TEST_CHECK(RingBufferStatisticsGet(NULL, &stat) == RB_ERROR_PARAM);
+    TEST_CHECK(RingBufferStatisticsGet(&rb, NULL) == RB_ERROR_PARAM);
+
+    printf("fresh ring\n");
+    TEST_CHECK(RingBufferStatisticsGet(&rb, &stat) == RB_OK);
+    TEST_CHECK(stat.size == RING_SIZE && stat.len == 0 && stat.highWaterMark == 0);
+    TEST_CHECK(stat.putCalls == 0 && stat.getCalls == 0);
+    TEST_CHECK(stat.avgPutSize == 0 && stat.avgGetSize == 0);
+
+    printf("full, short and empty\n");
+    TEST_CHECK(RingBufferPut(&rb, data, 10) == 10);
+    // 5 of 10 fit: a short put
+    TEST_CHECK(RingBufferPut(&rb, data, 10) == RING_SIZE - 1 - 10);
+    // Nothing fits: a full put
+    TEST_CHECK(RingBufferPut(&rb, data, 3) == 0);
+    TEST_CHECK(RingBufferGet(&rb, data, 4) == 4);
+    TEST_CHECK(RingBufferGet(&rb, data, sizeof(data)) == RING_SIZE - 1 - 4);
+    TEST_CHECK(RingBufferGet(&rb, data, 1) == 0);
+
+    TEST_CHECK(RingBufferStatisticsGet(&rb, &stat) == RB_OK);
+    TEST_CHECK(stat.len == 0);
+    TEST_CHECK(stat.highWaterMark == RING_SIZE - 1);
+    TEST_CHECK(stat.totalIn == RING_SIZE - 1 && stat.totalOut == RING_SIZE - 1);
+    TEST_CHECK(stat.putCalls == 3 && stat.getCalls == 3);
+    TEST_CHECK(stat.shortTimes == 1 && stat.fullTimes == 1 && stat.emptyTimes == 1);
+    TEST_CHECK(stat.truncatedBytes == 5 + 3);
+    TEST_CHECK(stat.avgPutSize == (RING_SIZE - 1) / 3);
+    TEST_CHECK(stat.avgGetSize == (RING_SIZE - 1) / 3);
+
+    printf("reset\n");
+    TEST_CHECK(RingBufferStatisticsReset(&rb) == RB_OK);
+    TEST_CHECK(RingBufferStatisticsGet(&rb, &stat) == RB_OK);
+    TEST_CHECK(stat.highWaterMark == 0 && stat.putCalls == 0 && stat.getCalls == 0);
+    TEST_CHECK(stat.fullTimes == 0 && stat.shortTimes == 0 && stat.emptyTimes == 0);
+    TEST_CHECK(stat.truncatedBytes == 0);
+    // Byte totals keep counting, the averages start over
+    TEST_CHECK(stat.totalIn == RING_SIZE - 1);
+    TEST_CHECK(RingBufferPut(&rb, data, 6) == 6);
+    TEST_CHECK(RingBufferPut(&rb, data, 2) == 2);
+    TEST_CHECK(RingBufferGet(&rb, data, 2) == 2);
+    TEST_CHECK(RingBufferStatisticsGet(&rb, &stat) == RB_OK);
+    TEST_CHECK(stat.highWaterMark == 8 && stat.len == 6);
+    TEST_CHECK(stat.avgPutSize == 4 && stat.avgGetSize == 2);
+
+    printf("transfer counts on both rings\n");
+    {
+        RingBuffer det;
+
+        TEST_CHECK(RingBufferCreate(&det, RING_SIZE / 2) == RB_OK);
+        // 6 readable, room for 7
+        TEST_CHECK(RingBufferTransfer(&det, &rb, sizeof(data), NULL, NULL) == 6);
+        TEST_CHECK(RingBufferStatisticsGet(&det, &stat) == RB_OK);
+        TEST_CHECK(stat.highWaterMark == 6 && stat.totalIn == 6);
+        TEST_CHECK(RingBufferStatisticsGet(&rb, &stat) == RB_OK);
+        TEST_CHECK(stat.len == 0 && stat.totalOut == stat.totalIn);
+        TEST_CHECK(RingBufferDelete(&det) == RB_OK);
+    }
+
+    TEST_CHECK(RingBufferDelete(&rb) == RB_OK);
+
+    if (g_errors == 0) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED! (%d errors)\n", g_errors);
+    return 1;
+}
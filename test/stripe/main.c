@@ -0,0 +1,195 @@
+#include "../../src/RingBuffer.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+// Test parameters
+#define RING_SIZE       (64)
+#define CHANNELS        (3)
+
+static int g_errors = 0;
+
+#define TEST_CHECK(cond)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond);     \
+            g_errors++;                                                     \
+        }                                                                   \
+    } while (0)
+
+/* Mock channel: remembers its block, the test plays the transfer */
+typedef struct {
+    RB_ADDRESS src;
+    RB_ADDRESS det;
+    uint32_t size;
+    uint32_t busy;
+} MockChannel;
+
+static MockChannel g_channel[CHANNELS];
+static uint8_t g_src[CHANNELS][RING_SIZE];
+
+static int MockConfig(void *ctx, RB_ADDRESS src, RB_ADDRESS det, uint32_t size)
+{
+    MockChannel *ch = (MockChannel *)ctx;
+
+    ch->src = src;
+    ch->det = det;
+    ch->size = size;
+    return 0;
+}
+
+static int MockStart(void *ctx)
+{
+    ((MockChannel *)ctx)->busy = 1;
+    return 0;
+}
+
+static int MockStop(void *ctx)
+{
+    ((MockChannel *)ctx)->busy = 0;
+    return 0;
+}
+
+static const RingBufferDMAOps g_ops = {
+    MockConfig, MockStart, MockStop, NULL, NULL, NULL
+};
+
+/* Fills the source of channel `ch` with `len` bytes starting at `first` */
+static int Start(RingBuffer *rb, uint32_t ch, uint8_t first, uint32_t len)
+{
+    uint32_t i;
+
+    for (i = 0; i < len; i++) {
+        g_src[ch][i] = (uint8_t)(first + i);
+    }
+    return RingBufferDMAStripeStart(rb, ch, (RB_ADDRESS)(uintptr_t)g_src[ch], len);
+}
+
+static int Complete(RingBuffer *rb, uint32_t ch)
+{
+    memcpy((void *)(uintptr_t)g_channel[ch].det, (const void *)(uintptr_t)g_channel[ch].src, g_channel[ch].size);
+    g_channel[ch].busy = 0;
+    return RingBufferDMAStripeComplete(rb, ch);
+}
+
+/* Reads `len` bytes, which must count up from `first`; a get stops at an unused end */
+static int Expect(RingBuffer *rb, uint8_t first, uint32_t len)
+{
+    uint8_t data[RING_SIZE];
+    uint32_t got = 0;
+    uint32_t n;
+    uint32_t i;
+
+    while (got < len) {
+        n = RingBufferGet(rb, &data[got], len - got);
+        if (n == 0) {
+            return 0;
+        }
+        got += n;
+    }
+    for (i = 0; i < len; i++) {
+        if (data[i] != (uint8_t)(first + i)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static RB_ADDRESS At(RingBuffer *rb, uint32_t offset)
+{
+    return (RB_ADDRESS)(uintptr_t)&rb->buff[offset];
+}
+
+int main()
+{
+    RingBuffer rb;
+    RingBufferDMAChannel channel[CHANNELS];
+    uint8_t byte;
+    uint32_t i;
+
+    memset(channel, 0, sizeof(channel));
+    for (i = 0; i < CHANNELS; i++) {
+        channel[i].ops = &g_ops;
+        channel[i].ctx = &g_channel[i];
+    }
+    TEST_CHECK(RingBufferCreate(&rb, RING_SIZE) == RB_OK);
+    TEST_CHECK(RingBufferDMAStripeRegister(&rb, channel, 0, NULL, NULL) == RB_ERROR_PARAM);
+    TEST_CHECK(RingBufferDMAStripeRegister(&rb, channel, RINGBUFFER_DMA_STRIPE_CHANNELS + 1, NULL, NULL) == RB_ERROR_PARAM);
+    TEST_CHECK(RingBufferDMAStripeRegister(&rb, channel, CHANNELS, NULL, NULL) == RB_OK);
+    // The channels own the write side
+    TEST_CHECK(RingBufferDMAConfig(&rb, (RB_ADDRESS)(uintptr_t)g_src[0], 8) == RB_ERROR_INVALID);
+
+    printf("consecutive regions\n");
+    TEST_CHECK(Start(&rb, 0, 0, 10) == RB_OK);
+    TEST_CHECK(Start(&rb, 1, 10, 12) == RB_OK);
+    TEST_CHECK(Start(&rb, 2, 22, 8) == RB_OK);
+    TEST_CHECK(Start(&rb, 0, 0, 1) == RB_ERROR_LOCKED);
+    TEST_CHECK(RingBufferDMAStripeStart(&rb, CHANNELS, (RB_ADDRESS)(uintptr_t)g_src[0], 1) == RB_ERROR_PARAM);
+    TEST_CHECK(g_channel[0].det == At(&rb, 0) && g_channel[0].size == 10);
+    TEST_CHECK(g_channel[1].det == At(&rb, 10) && g_channel[1].size == 12);
+    TEST_CHECK(g_channel[2].det == At(&rb, 22) && g_channel[2].size == 8);
+
+    printf("tail follows the finished prefix\n");
+    TEST_CHECK(Complete(&rb, 2) == RB_OK);
+    TEST_CHECK(RingBufferDMAStripeComplete(&rb, 2) == RB_ERROR_INVALID);
+    TEST_CHECK(RingBufferLenGet(&rb) == 0);
+    TEST_CHECK(RingBufferGet(&rb, &byte, 1) == 0);
+    TEST_CHECK(Complete(&rb, 0) == RB_OK);
+    TEST_CHECK(RingBufferLenGet(&rb) == 10);
+    TEST_CHECK(Complete(&rb, 1) == RB_OK);
+    TEST_CHECK(RingBufferLenGet(&rb) == 30 && RingBufferTotalInGet(&rb) == 30);
+    TEST_CHECK(Expect(&rb, 0, 30));
+
+    printf("a stripe too long for the rest wraps to the start\n");
+    // Reservations at 30 and 50, the second cannot fit in the 14 bytes left
+    TEST_CHECK(Start(&rb, 0, 30, 20) == RB_OK);
+    TEST_CHECK(Start(&rb, 1, 50, 20) == RB_OK);
+    TEST_CHECK(g_channel[0].det == At(&rb, 30));
+    TEST_CHECK(g_channel[1].det == At(&rb, 0));
+    // Unread data and the unused end leave too little room
+    TEST_CHECK(Start(&rb, 2, 70, 20) == RB_ERROR_LOCKED);
+    TEST_CHECK(Complete(&rb, 1) == RB_OK);
+    TEST_CHECK(RingBufferLenGet(&rb) == 0);
+    TEST_CHECK(Complete(&rb, 0) == RB_OK);
+    TEST_CHECK(RingBufferLenGet(&rb) == 20);
+    // The first get stops at the unused end, the next one jumps it
+    TEST_CHECK(RingBufferGet(&rb, g_src[2], RING_SIZE) == 20);
+    TEST_CHECK(g_src[2][0] == 30 && g_src[2][19] == 49);
+    TEST_CHECK(Expect(&rb, 50, 20));
+    TEST_CHECK(RingBufferTotalInGet(&rb) == 70 && RingBufferTotalOutGet(&rb) == 70);
+
+    printf("stop drops the stripes in flight\n");
+    TEST_CHECK(Start(&rb, 0, 70, 10) == RB_OK);
+    TEST_CHECK(Start(&rb, 1, 80, 10) == RB_OK);
+    TEST_CHECK(Complete(&rb, 1) == RB_OK);
+    TEST_CHECK(RingBufferDMAStop(&rb) == RB_OK);
+    TEST_CHECK(!g_channel[0].busy);
+    TEST_CHECK(RingBufferLenGet(&rb) == 0 && RingBufferTotalInGet(&rb) == 70);
+    // The next stripe reserves from tail again
+    TEST_CHECK(Start(&rb, 2, 90, 10) == RB_OK);
+    TEST_CHECK(g_channel[2].det == At(&rb, 20));
+    TEST_CHECK(Complete(&rb, 2) == RB_OK);
+    TEST_CHECK(Expect(&rb, 90, 10));
+
+    printf("stream, completions in reverse order\n");
+    for (i = 0; i < 40; i++) {
+        TEST_CHECK(Start(&rb, 0, (uint8_t)(i * 21), 7) == RB_OK);
+        TEST_CHECK(Start(&rb, 1, (uint8_t)(i * 21 + 7), 7) == RB_OK);
+        TEST_CHECK(Start(&rb, 2, (uint8_t)(i * 21 + 14), 7) == RB_OK);
+        TEST_CHECK(Complete(&rb, 2) == RB_OK);
+        TEST_CHECK(Complete(&rb, 1) == RB_OK);
+        TEST_CHECK(Complete(&rb, 0) == RB_OK);
+        TEST_CHECK(Expect(&rb, (uint8_t)(i * 21), 21));
+    }
+
+    TEST_CHECK(RingBufferDMADeviceUnregister(&rb) == RB_OK);
+    TEST_CHECK(RingBufferDelete(&rb) == RB_OK);
+
+    if (g_errors == 0) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED! (%d errors)\n", g_errors);
+    return 1;
+}
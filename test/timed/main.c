@@ -0,0 +1,138 @@
+#include "../../src/RingBufferTimed.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+// Test parameters
+#define RING_SIZE       (1024)
+#define REC_SIZE        (20)
+#define REC_COUNT       (30)            // About 1 KB, spans many index strides
+
+static int g_errors = 0;
+
+#define TEST_CHECK(cond)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond);     \
+            g_errors++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static uint8_t g_rec[REC_SIZE];
+
+static void record(uint32_t n)
+{
+    memset(g_rec, (int)n, sizeof(g_rec));
+}
+
+// Puts records with timestamps 10, 20, ... until the ring is full, returns how many went in
+static uint32_t fill(RingBufferTimed *rt, uint32_t first)
+{
+    uint32_t n;
+
+    for (n = first; n < first + REC_COUNT * 2; n++) {
+        record(n);
+        if (RingBufferTimedPut(rt, (uint64_t)n * 10, g_rec, REC_SIZE) != RB_OK) {
+            break;
+        }
+    }
+
+    return n - first;
+}
+
+// The next record carries timestamp n * 10 and bytes of value n
+static int next(RingBufferTimed *rt, uint32_t n)
+{
+    uint8_t data[REC_SIZE];
+    uint64_t ts = 0;
+
+    record(n);
+    if (RingBufferTimedGet(rt, &ts, data, sizeof(data)) != REC_SIZE) {
+        return 0;
+    }
+
+    return ts == (uint64_t)n * 10 && memcmp(data, g_rec, REC_SIZE) == 0;
+}
+
+int main()
+{
+    RingBuffer rb;
+    RingBufferTimed rt;
+    uint8_t small[4];
+    uint64_t ts;
+    uint32_t size;
+    uint32_t count;
+
+    TEST_CHECK(RingBufferCreate(&rb, RING_SIZE) == RB_OK);
+    TEST_CHECK(RingBufferTimedCreate(&rt, &rb) == RB_OK);
+
+    printf("records in and out\n");
+    TEST_CHECK(RingBufferTimedPeek(&rt, &ts, &size) == RB_ERROR_LOCKED);
+    TEST_CHECK(RingBufferTimedGet(&rt, &ts, small, sizeof(small)) == 0);
+    record(1);
+    TEST_CHECK(RingBufferTimedPut(&rt, 10, g_rec, REC_SIZE) == RB_OK);
+    TEST_CHECK(RingBufferTimedPut(&rt, 5, g_rec, REC_SIZE) == RB_ERROR_PARAM);
+    TEST_CHECK(RingBufferTimedPut(&rt, 10, g_rec, RING_SIZE) == RB_ERROR_PARAM);
+    TEST_CHECK(RingBufferTimedPeek(&rt, &ts, &size) == RB_OK);
+    TEST_CHECK(ts == 10 && size == REC_SIZE);
+    // A short buffer gets the front, the rest of the record is dropped
+    TEST_CHECK(RingBufferTimedGet(&rt, &ts, small, sizeof(small)) == REC_SIZE);
+    TEST_CHECK(small[0] == 1 && RingBufferLenGet(&rb) == 0);
+
+    printf("full ring refuses whole records\n");
+    count = fill(&rt, 2);
+    TEST_CHECK(count == (RING_SIZE - 1) / (RINGBUFFER_TIMED_HEADER_SIZE + REC_SIZE));
+    TEST_CHECK(RingBufferTimedPut(&rt, 10000, g_rec, REC_SIZE) == RB_ERROR_LOCKED);
+    TEST_CHECK(next(&rt, 2));
+
+    printf("seek through the index\n");
+    TEST_CHECK(rt.indexIn > 1);
+    TEST_CHECK(RingBufferTimedSeek(&rt, 155) == RB_OK);
+    TEST_CHECK(next(&rt, 16));
+    // Exact hit
+    TEST_CHECK(RingBufferTimedSeek(&rt, 250) == RB_OK);
+    TEST_CHECK(next(&rt, 25));
+    // Seeking back does nothing, the past is gone
+    TEST_CHECK(RingBufferTimedSeek(&rt, 0) == RB_OK);
+    TEST_CHECK(next(&rt, 26));
+    // Past the newest record: everything is dropped
+    TEST_CHECK(RingBufferTimedSeek(&rt, 100000) == RB_OK);
+    TEST_CHECK(RingBufferLenGet(&rb) == 0);
+
+    printf("wraps and index reuse\n");
+    count = fill(&rt, 100);
+    TEST_CHECK(count > 20);
+    TEST_CHECK(RingBufferTimedSeek(&rt, (100 + count - 3) * 10) == RB_OK);
+    TEST_CHECK(next(&rt, 100 + count - 3));
+    TEST_CHECK(next(&rt, 100 + count - 2));
+    TEST_CHECK(next(&rt, 100 + count - 1));
+    TEST_CHECK(RingBufferLenGet(&rb) == 0);
+
+#if RINGBUFFER_USE_DEFERRED_PUBLISH
+    printf("seek on a batched ring stays behind the published tail\n");
+    TEST_CHECK(RingBufferTimedDelete(&rt) == RB_OK);
+    TEST_CHECK(RingBufferPublishBatchSet(&rb, RING_SIZE / 2) == RB_OK);
+    TEST_CHECK(RingBufferTimedCreate(&rt, &rb) == RB_OK);
+    count = fill(&rt, 200);
+    TEST_CHECK(count > 0);
+    TEST_CHECK(RingBufferLenGet(&rb) < count * (RINGBUFFER_TIMED_HEADER_SIZE + REC_SIZE));
+    TEST_CHECK(RingBufferTimedSeek(&rt, (200 + count - 1) * 10) == RB_OK);
+    TEST_CHECK(RingBufferTotalOutGet(&rb) <= RingBufferTotalInGet(&rb));
+    TEST_CHECK(RingBufferTimedPeek(&rt, &ts, &size) == RB_ERROR_LOCKED);
+    TEST_CHECK(RingBufferFlush(&rb) == RB_OK);
+    TEST_CHECK(RingBufferTimedSeek(&rt, (200 + count - 1) * 10) == RB_OK);
+    TEST_CHECK(next(&rt, 200 + count - 1));
+    TEST_CHECK(RingBufferLenGet(&rb) == 0);
+#endif  /* RINGBUFFER_USE_DEFERRED_PUBLISH */
+
+    TEST_CHECK(RingBufferTimedDelete(&rt) == RB_OK);
+    TEST_CHECK(RingBufferDelete(&rb) == RB_OK);
+
+    if (g_errors == 0) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED! (%d errors)\n", g_errors);
+    return 1;
+}
@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Route the probes into a log, then build the library into this test */
+typedef struct {
+    const char *name;
+    uint64_t arg[4];
+} Probe;
+
+static Probe g_probe[64];
+static uint32_t g_probes;
+
+static void Record(const char *name, uint64_t a2, uint64_t a3, uint64_t a4, uint64_t a5)
+{
+    if (g_probes < sizeof(g_probe) / sizeof(g_probe[0])) {
+        g_probe[g_probes].name = name;
+        g_probe[g_probes].arg[0] = a2;
+        g_probe[g_probes].arg[1] = a3;
+        g_probe[g_probes].arg[2] = a4;
+        g_probe[g_probes].arg[3] = a5;
+    }
+    g_probes++;
+}
+
+#define RB_TRACE3(name, a1, a2, a3)                 \
+    do { (void)(a1); Record(#name, (uint64_t)(a2), (uint64_t)(a3), 0, 0); } while (0)
+#define RB_TRACE4(name, a1, a2, a3, a4)             \
+    do { (void)(a1); Record(#name, (uint64_t)(a2), (uint64_t)(a3), (uint64_t)(a4), 0); } while (0)
+#define RB_TRACE5(name, a1, a2, a3, a4, a5)         \
+    do { (void)(a1); Record(#name, (uint64_t)(a2), (uint64_t)(a3), (uint64_t)(a4), (uint64_t)(a5)); } while (0)
+
+#include "../../src/RingBuffer.c"
+
+// Test parameters
+#define RING_SIZE       (16)
+#define PERIPH_ADDR     (0x40001000)
+
+static int g_errors = 0;
+
+#define TEST_CHECK(cond)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond);     \
+            g_errors++;                                                     \
+        }                                                                   \
+    } while (0)
+
+/* The last probe fired, with its arguments after the ring */
+static int Last(const char *name, uint64_t a2, uint64_t a3, uint64_t a4, uint64_t a5)
+{
+    const Probe *p;
+
+    if (g_probes == 0) {
+        return 0;
+    }
+    p = &g_probe[g_probes - 1];
+    return strcmp(p->name, name) == 0 &&
+           p->arg[0] == a2 && p->arg[1] == a3 && p->arg[2] == a4 && p->arg[3] == a5;
+}
+
+static int MockConfig(RB_ADDRESS src, RB_ADDRESS det, uint32_t size)
+{
+    (void)src;
+    (void)det;
+    (void)size;
+    return 0;
+}
+
+static uint32_t MockRecvedLen(void)
+{
+    return 0;
+}
+
+int main()
+{
+    RingBuffer rb;
+    uint8_t data[RING_SIZE * 2];
+
+    memset(data, 0x33, sizeof(data));
+    TEST_CHECK(RingBufferCreate(&rb, RING_SIZE) == RB_OK);
+
+    printf("put and get\n");
+    // Requested, moved, index after, occupancy after
+    TEST_CHECK(RingBufferPut(&rb, data, 10) == 10);
+    TEST_CHECK(Last("put", 10, 10, 10, 10));
+    TEST_CHECK(RingBufferPut(&rb, data, 10) == 5);
+    TEST_CHECK(Last("put", 10, 5, 15, 15));
+    TEST_CHECK(RingBufferPut(&rb, data, 3) == 0);
+    TEST_CHECK(Last("put", 3, 0, 15, 15));
+    TEST_CHECK(RingBufferGet(&rb, data, 4) == 4);
+    TEST_CHECK(Last("get", 4, 4, 4, 11));
+    TEST_CHECK(RingBufferGet(&rb, data, sizeof(data)) == 11);
+    TEST_CHECK(Last("get", sizeof(data), 11, 15, 0));
+    TEST_CHECK(RingBufferGet(&rb, data, 1) == 0);
+    TEST_CHECK(Last("get", 1, 0, 15, 0));
+
+    printf("dma transmit\n");
+    TEST_CHECK(RingBufferDMATxDeviceRegister(&rb, MockConfig, NULL, NULL, MockRecvedLen, NULL, NULL) == RB_OK);
+    TEST_CHECK(RingBufferDMATxStart(&rb, PERIPH_ADDR) == RB_OK);
+    // head and tail at 15: one byte to the border, then the wrap
+    TEST_CHECK(RingBufferPut(&rb, data, 9) == 9);
+    TEST_CHECK(Last("dma_start", (uint64_t)(uintptr_t)&rb.buff[15], 1, 15, 0));
+    TEST_CHECK(RingBufferDMAComplete(&rb) == RB_OK);
+    TEST_CHECK(Last("dma_start", (uint64_t)(uintptr_t)&rb.buff[0], 8, 0, 0));
+    TEST_CHECK(RingBufferDMAComplete(&rb) == RB_OK);
+    TEST_CHECK(RingBufferPut(&rb, data, 12) == 12);
+    // head at 8, tail wrapped to 4: 12 bytes still queued
+    TEST_CHECK(Last("dma_start", (uint64_t)(uintptr_t)&rb.buff[8], 8, 8, 0));
+    TEST_CHECK(RingBufferDMAStop(&rb) == RB_OK);
+    TEST_CHECK(Last("dma_stop", 0, 8, 12, 0));
+    TEST_CHECK(RingBufferDMADeviceUnregister(&rb) == RB_OK);
+
+    TEST_CHECK(g_probes <= sizeof(g_probe) / sizeof(g_probe[0]));
+    TEST_CHECK(RingBufferDelete(&rb) == RB_OK);
+
+    if (g_errors == 0) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED! (%d errors)\n", g_errors);
+    return 1;
+}
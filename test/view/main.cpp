@@ -0,0 +1,101 @@
+#include "../../src/RingBufferView.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+
+// Test parameters
+#define RING_SIZE       (16)
+
+static int g_errors = 0;
+
+#define TEST_CHECK(cond)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond);     \
+            g_errors++;                                                     \
+        }                                                                   \
+    } while (0)
+
+int main()
+{
+    RingBuffer rb;
+    uint8_t data[RING_SIZE];
+    uint8_t out[RING_SIZE];
+    uint32_t i;
+
+    for (i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i + 1);
+    }
+    TEST_CHECK(RingBufferCreate(&rb, RING_SIZE) == RB_OK);
+
+    printf("empty view\n");
+    {
+        RingBufferView view(&rb);
+
+        TEST_CHECK(view.empty() && view.size() == 0);
+        TEST_CHECK(view.begin() == view.end());
+        TEST_CHECK(view.Consume(1) == 0);
+    }
+
+    printf("iterators across the wrap\n");
+    // Readable region starts 4 bytes before the end of the buffer
+    TEST_CHECK(RingBufferPut(&rb, data, RING_SIZE - 4) == RING_SIZE - 4);
+    TEST_CHECK(RingBufferGet(&rb, out, RING_SIZE - 4) == RING_SIZE - 4);
+    TEST_CHECK(RingBufferPut(&rb, data, 10) == 10);
+    {
+        RingBufferView view(&rb);
+
+        TEST_CHECK(view.size() == 10);
+        TEST_CHECK(view.FirstSize() == 4 && view.SecondSize() == 6);
+        TEST_CHECK(memcmp(view.FirstData(), data, 4) == 0);
+        TEST_CHECK(memcmp(view.SecondData(), &data[4], 6) == 0);
+        TEST_CHECK(std::equal(view.begin(), view.end(), data));
+        TEST_CHECK(std::accumulate(view.begin(), view.end(), 0) == 55);
+        TEST_CHECK(std::find(view.begin(), view.end(), 7) - view.begin() == 6);
+        TEST_CHECK(view.end() - view.begin() == 10);
+        TEST_CHECK(view[3] == 4 && view[4] == 5 && view.begin()[9] == 10);
+        TEST_CHECK(*(view.end() - 1) == 10);
+        TEST_CHECK(std::lower_bound(view.begin(), view.end(), 8) - view.begin() == 7);
+#if RINGBUFFER_VIEW_SPAN
+        TEST_CHECK(view.First().size() == 4 && view.Second().size() == 6);
+        TEST_CHECK(view.Second()[0] == 5);
+#endif
+
+        printf("producer writes behind the snapshot\n");
+        TEST_CHECK(RingBufferPut(&rb, &data[10], 3) == 3);
+        TEST_CHECK(view.size() == 10);
+        view.Refresh();
+        TEST_CHECK(view.size() == 13);
+        TEST_CHECK(std::equal(view.begin(), view.end(), data));
+
+        printf("consume\n");
+        TEST_CHECK(view.Consume(5) == 5);
+        TEST_CHECK(view.size() == 8 && view[0] == 6);
+        TEST_CHECK(view.FirstSize() == 8 && view.SecondSize() == 0);
+        TEST_CHECK(RingBufferLenGet(&rb) == 8);
+        TEST_CHECK(RingBufferTotalOutGet(&rb) == RING_SIZE - 4 + 5);
+        TEST_CHECK(view.Consume(100) == 8);
+        TEST_CHECK(view.empty() && RingBufferLenGet(&rb) == 0);
+    }
+
+    printf("checked get after a consume\n");
+    TEST_CHECK(RingBufferPut(&rb, data, 6) == 6);
+    {
+        RingBufferView view(&rb);
+
+        TEST_CHECK(view.Consume(2) == 2);
+    }
+    TEST_CHECK(RingBufferGet(&rb, out, sizeof(out)) == 4);
+    TEST_CHECK(memcmp(out, &data[2], 4) == 0);
+
+    TEST_CHECK(RingBufferDelete(&rb) == RB_OK);
+
+    if (g_errors == 0) {
+        printf("\nTest PASSED!\n");
+        return 0;
+    }
+
+    printf("\nTest FAILED! (%d errors)\n", g_errors);
+    return 1;
+}